@@ -10,13 +10,248 @@
 
 
 #include "simulator/Simulator.h"
+#include "simulator/BatchRunner.h"
+#include "simulator/ScenarioRunner.h"
+#include "simulator/Benchmark.h"
+#include "simulator/CarFollowing.h"
+#include "simulator/VehicleStore.h"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#endif // _WIN32
+
 using namespace std;
 
+void printUsage()
+{
+    cout << "Usage:" << endl;
+    cout << "  traffic [--headless] [--turbo]" << endl;
+    cout << "  traffic --batch [--road FILE] [--rules FILE] [--step SECONDS]" << endl;
+    cout << "                  [--duration SECONDS] [--seed N] [--out DIR | --no-summary]" << endl;
+    cout << "                  [--scenarios N] [--threads N] [--workers N]" << endl;
+    cout << "                  [--processes N | --hosts HOST,HOST... --node K] [--port PORT]" << endl;
+    cout << "                  [--kernel scalar|avx2|avx512] [--fast-math] [--no-sleep]" << endl;
+    cout << "                  [--max-rate N]" << endl;
+    cout << "  traffic --benchmark NAME" << endl;
+    Benchmark::printNames();
+}
+
+const char *optionValue(int argc, char** argv, int &i)
+{
+    if (i + 1 >= argc) throw ExceptionClass(string("missing value for option ") + argv[i]);
+    return argv[++i];
+}
+
+CarFollowing::Isa findKernel(const string &name)
+{
+    CarFollowing::Isa isa = CarFollowing::findIsa(name);
+
+    if (isa == CarFollowing::ISAS) throw ExceptionClass("unknown kernel " + name);
+    if (!CarFollowing::isSupported(isa)) throw ExceptionClass("kernel " + name + " is not supported by this CPU");
+
+    return isa;
+}
+
+int findMaxRate(const string &value)
+{
+    char *end = nullptr;
+    const long rate = strtol(value.c_str(), &end, 10);
+
+    if (value.empty() || *end != '\0' || rate < 0 || rate > VehicleStore::MAX_RATE)
+        throw ExceptionClass("max rate must be a number from 0 to " + to_string(VehicleStore::MAX_RATE));
+
+    return rate;
+}
+
+vector<string> splitList(const string &list)
+{
+    vector<string> items;
+    string item;
+    istringstream ss(list);
+
+    while (getline(ss, item, ','))
+    {
+        items.push_back(item);
+    }
+
+    return items;
+}
+
+//One simulation shared by processes on this machine, connected over the loopback;
+//this process is the first node and reports the results
+int runProcesses(BatchConfig config)
+{
+#ifdef _WIN32
+    throw ExceptionClass("running many processes is not supported on Windows");
+#else
+    vector<pid_t> children;
+    cout.flush();
+
+    for (unsigned int k = 1; k < config.hosts.size(); k++)
+    {
+        pid_t pid = fork();
+        if (pid < 0) throw ExceptionClass("failed to start process");
+
+        if (pid == 0)
+        {
+            config.node = k;
+
+            try
+            {
+                BatchRunner runner(config);
+                runner.run();
+            }
+            //nothing may unwind past here, the child must not run the exit path of the parent
+            catch (const ExceptionClass &e)
+            {
+                cout << "ERROR (node " << k << "): " << e.what() << endl;
+                _exit(1);
+            }
+            catch (const exception &e)
+            {
+                cout << "ERROR (node " << k << "): unexpected error: " << e.what() << endl;
+                _exit(1);
+            }
+
+            _exit(0);
+        }
+
+        children.push_back(pid);
+    }
+
+    config.node = 0;
+    BatchRunner runner(config);
+    runner.run();
+
+    int result = 0;
+    for (auto pid : children)
+    {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) result = 1;
+    }
+
+    return result;
+#endif // _WIN32
+}
+
+int runBatch(int argc, char** argv)
+{
+    BatchConfig config;
+    int scenariosNumber = 1;
+    int threadsNumber = 0;
+    int processesNumber = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+             if (strcmp(argv[i], "--batch") == 0)       continue;
+        else if (strcmp(argv[i], "--road") == 0)        config.roadFile = optionValue(argc, argv, i);
+        else if (strcmp(argv[i], "--rules") == 0)       config.rightOfWayFile = optionValue(argc, argv, i);
+        else if (strcmp(argv[i], "--out") == 0)         config.outputDir = optionValue(argc, argv, i);
+        else if (strcmp(argv[i], "--no-summary") == 0)  config.saveSummary = false;
+        else if (strcmp(argv[i], "--step") == 0)        config.timeStep = atof(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--duration") == 0)    config.duration = atof(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--seed") == 0)        config.seed = strtoul(optionValue(argc, argv, i), NULL, 10);
+        else if (strcmp(argv[i], "--scenarios") == 0)   scenariosNumber = atoi(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--threads") == 0)     threadsNumber = atoi(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--workers") == 0)     config.workers = atoi(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--processes") == 0)   processesNumber = atoi(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--hosts") == 0)       config.hosts = splitList(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--node") == 0)        config.node = atoi(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--port") == 0)        config.port = atoi(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--kernel") == 0)      config.kernel = findKernel(optionValue(argc, argv, i));
+        else if (strcmp(argv[i], "--fast-math") == 0)   config.deterministic = false;
+        else if (strcmp(argv[i], "--no-sleep") == 0)    config.sleeping = false;
+        else if (strcmp(argv[i], "--max-rate") == 0)    config.maxRate = findMaxRate(optionValue(argc, argv, i));
+        else throw ExceptionClass(string("unknown option ") + argv[i]);
+    }
+
+    if (processesNumber > 1 || config.hosts.size() > 1)
+    {
+        if (scenariosNumber > 1) throw ExceptionClass("scenarios can't be run by many processes");
+
+        if (processesNumber > 1)
+        {
+            config.hosts.assign(processesNumber, "127.0.0.1");
+            return runProcesses(config);
+        }
+    }
+
+    if (scenariosNumber <= 1)
+    {
+        BatchRunner runner(config);
+        runner.run();
+
+        return 0;
+    }
+
+    //every scenario gets its own seed and output directory
+    ScenarioRunner runner(threadsNumber);
+    for (int i = 0; i < scenariosNumber; i++)
+    {
+        BatchConfig scenario = config;
+        scenario.seed = config.seed + i;
+        scenario.outputDir = config.outputDir + "/scenario_" + to_string(i);
+
+        runner.addScenario(scenario);
+    }
+    runner.run();
+
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
     EngineCore::SetCmdArgs(argc, argv);
 
+    bool headless = false;
+    bool turbo = false;
+    bool batch = false;
+    for (int i = 1; i < argc; i++)
+    {
+             if (strcmp(argv[i], "--headless") == 0)    headless = true;
+        else if (strcmp(argv[i], "--turbo") == 0)       turbo = true;
+        else if (strcmp(argv[i], "--batch") == 0)       batch = true;
+        else if (strcmp(argv[i], "--help") == 0)
+        {
+            printUsage();
+            return 0;
+        }
+        else if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            try
+            {
+                Benchmark::run(optionValue(argc, argv, i));
+                return 0;
+            }
+            catch (ExceptionClass e)
+            {
+                cout << "ERROR: " << e.what() << endl;
+                printUsage();
+                return 1;
+            }
+        }
+    }
+
+    if (batch)
+    {
+        try
+        {
+            return runBatch(argc, argv);
+        }
+        catch (ExceptionClass e)
+        {
+            cout << "ERROR: " << e.what() << endl;
+            printUsage();
+            return 1;
+        }
+    }
+
     cout << "      Project for OOP subject at Warsaw University of Technology" << endl;
     cout << "      City traffic simulation" << endl;
     cout << "      Copyright (C) Robert Dudzinski 2018" << endl;
@@ -27,18 +262,22 @@ int main(int argc, char** argv)
     cout << endl;
     cout << " T, Y          - decrease/increase updates per frame" << endl;
     cout << " G, H          - decrease/increase time scale" << endl;
+    cout << " U             - turbo mode on/off (fixed step, as fast as possible)" << endl;
     cout << endl;
     cout << " dragging cursor - rotating camera" << endl;
     cout << endl;
-    cout << " ESC           - exit" << endl << endl << endl;
+    cout << " ESC           - exit" << endl;
+    cout << endl;
+    cout << " --headless    - run without a window (stop with Ctrl+C)" << endl;
+    cout << " --turbo       - start in turbo mode" << endl << endl << endl;
 
     try
     {
-        Simulator *simulator = &Simulator::getInstance();
+        Simulator simulator;
 
-        simulator->loadRoad("exampleRoad.txt");
-        simulator->loadRightOfWay("exampleRightOfWay.txt");
-        simulator->run();
+        simulator.loadRoad("exampleRoad.txt");
+        simulator.loadRightOfWay("exampleRightOfWay.txt");
+        simulator.run(headless, turbo);
     }
     catch (exception e)
     {
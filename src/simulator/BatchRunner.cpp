@@ -0,0 +1,219 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: BatchRunner.cpp
+
+
+#include "BatchRunner.h"
+#include "Simulation.h"
+#include "EngineCore/Cluster.h"
+#include "CarFollowing.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cerrno>
+#include <memory>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif // _WIN32
+
+using namespace std;
+
+BatchConfig::BatchConfig()
+{
+    roadFile = "exampleRoad.txt";
+    rightOfWayFile = "exampleRightOfWay.txt";
+    outputDir = ".";
+    saveSummary = true;
+
+    timeStep = 0.02;
+    duration = 3600;
+    seed = 1;
+    workers = 1;
+    kernel = CarFollowing::findBestIsa();
+    deterministic = true;
+    sleeping = true;
+    maxRate = VehicleStore::MAX_RATE;
+    node = 0;
+    port = 47100;
+}
+
+BatchRunner::BatchRunner(const BatchConfig &batchConfig, const bool verboseRun)
+{
+    config = batchConfig;
+    verbose = verboseRun;
+
+    nodes = config.hosts.size() > 1 ? config.hosts.size() : 1;
+    if (config.node < 0 || config.node >= nodes) throw ExceptionClass("node number must be lower than the number of nodes");
+
+    //only the first node reports the results of a distributed run
+    if (config.node != 0)
+    {
+        verbose = false;
+        config.saveSummary = false;
+    }
+
+    if (config.saveSummary && config.outputDir.empty()) throw ExceptionClass("output directory must not be empty");
+
+    if (config.timeStep <= 0) throw ExceptionClass("time step must be positive");
+    if (config.duration <= 0) throw ExceptionClass("duration must be positive");
+
+    ticks = 0;
+    vehicleUpdates = 0;
+    awakeUpdates = 0;
+    coastingUpdates = 0;
+    simulatedTime = 0;
+    wallTime = 0;
+}
+
+void BatchRunner::run()
+{
+    unique_ptr<Cluster> cluster;
+    if (nodes > 1) cluster.reset(new Cluster(config.node, config.hosts, config.port));
+
+    Simulation simulation(config.seed);
+
+    simulation.setVerbose(verbose);
+    simulation.setWorkers(config.workers);
+    simulation.getVehicleStore().setSleeping(config.sleeping);
+    simulation.getVehicleStore().setMaxRate(config.maxRate);
+    if (!simulation.getVehicleStore().setKernel(config.kernel, config.deterministic)) throw ExceptionClass(string("kernel ") + CarFollowing::getIsaName(config.kernel) + " is not supported by this CPU");
+    simulation.setCluster(cluster.get());
+    simulation.loadRoad(config.roadFile);
+    simulation.loadRightOfWay(config.rightOfWayFile);
+
+    long long ticksToRun = (long long)ceil(config.duration / config.timeStep);
+
+    if (verbose) cout << "Running " << ticksToRun << " ticks of " << config.timeStep << " s" << endl;
+
+    chrono::steady_clock::time_point begTime = chrono::steady_clock::now();
+
+    for (ticks = 0; ticks < ticksToRun; ticks++)
+    {
+        vehicleUpdates += simulation.getVehiclesCount();
+        simulation.step(config.timeStep);
+        awakeUpdates += simulation.getVehicleStore().getAwakeCount();
+        coastingUpdates += simulation.getVehicleStore().getCoastingCount();
+    }
+
+    chrono::steady_clock::time_point endTime = chrono::steady_clock::now();
+
+    wallTime = chrono::duration<double>(endTime - begTime).count();
+    simulatedTime = ticks * (double)config.timeStep;
+
+    if (cluster) gatherResults(*cluster);
+
+    if (verbose) printSummary(cout);
+    if (config.saveSummary) writeSummary();
+}
+
+//Every node counted only its own vehicles; the run lasted as long as the slowest node
+void BatchRunner::gatherResults(Cluster &cluster)
+{
+    vector<Message> out(nodes), in;
+
+    for (int k = 0; k < nodes; k++)
+    {
+        out[k].put(vehicleUpdates);
+        out[k].put(awakeUpdates);
+        out[k].put(coastingUpdates);
+        out[k].put(wallTime);
+    }
+
+    cluster.exchange(out, in);
+
+    for (int k = 0; k < nodes; k++)
+    {
+        if (k == config.node) continue;
+
+        vehicleUpdates += in[k].get<long long>();
+        awakeUpdates += in[k].get<long long>();
+        coastingUpdates += in[k].get<long long>();
+        wallTime = max(wallTime, in[k].get<double>());
+    }
+}
+
+long long BatchRunner::getTicks() const
+{
+    return ticks;
+}
+
+long long BatchRunner::getVehicleUpdates() const
+{
+    return vehicleUpdates;
+}
+
+double BatchRunner::getSimulatedTime() const
+{
+    return simulatedTime;
+}
+
+double BatchRunner::getWallTime() const
+{
+    return wallTime;
+}
+
+void BatchRunner::printSummary(ostream &out) const
+{
+    double safeWallTime = wallTime > 0 ? wallTime : 1e-9;
+
+    out << "seed:                " << config.seed << endl;
+    out << "time step:           " << config.timeStep << " s" << endl;
+    out << "workers:             " << config.workers << endl;
+    out << "kernel:              " << CarFollowing::getIsaName(config.kernel) << (config.deterministic ? "" : " (fast math)") << endl;
+    if (nodes > 1) out << "nodes:               " << nodes << endl;
+    out << "simulated time:      " << simulatedTime << " s" << endl;
+    out << "ticks:               " << ticks << endl;
+    out << "wall time:           " << wallTime << " s" << endl;
+    out << "ticks per second:    " << ticks / safeWallTime << endl;
+    out << "vehicle updates:     " << vehicleUpdates << endl;
+    out << "vehicle updates/s:   " << vehicleUpdates / safeWallTime << endl;
+    if (config.sleeping) out << "asleep:              " << 100.0 * (vehicleUpdates - awakeUpdates) / max(vehicleUpdates, 1LL) << " % of vehicle updates" << endl;
+    if (config.maxRate > 0) out << "coasting:            " << 100.0 * coastingUpdates / max(vehicleUpdates, 1LL) << " % of vehicle updates" << endl;
+    out << "simulated s/wall s:  " << simulatedTime / safeWallTime << endl;
+}
+
+void BatchRunner::createDirectory(const string dirName) const
+{
+    //creates also all missing parent directories
+    for (unsigned int i = 1; i <= dirName.size(); i++)
+    {
+        if (i < dirName.size() && dirName[i] != '/' && dirName[i] != '\\') continue;
+
+        string path = dirName.substr(0, i);
+
+#ifdef _WIN32
+        int result = _mkdir(path.c_str());
+#else
+        int result = mkdir(path.c_str(), 0755);
+#endif // _WIN32
+        if (result != 0 && errno != EEXIST) throw ExceptionClass("failed to create output directory " + path);
+    }
+}
+
+void BatchRunner::writeSummary() const
+{
+    createDirectory(config.outputDir);
+
+    string fileName = config.outputDir + "/summary.txt";
+
+    ofstream file;
+    file.open(fileName.c_str());
+    if (!file.good()) throw ExceptionClass("failed to open file " + fileName);
+
+    printSummary(file);
+    file.close();
+
+    if (verbose) cout << "Summary saved to " << fileName << endl;
+}
@@ -0,0 +1,92 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: BatchRunner.h
+
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <string>
+#include <vector>
+
+#include "EngineCore/ExceptionClass.h"
+#include "CarFollowing.h"
+
+class Cluster;
+
+struct BatchConfig
+{
+    std::string roadFile;
+    std::string rightOfWayFile;
+    std::string outputDir;
+
+    //summary.txt is written to outputDir unless turned off
+    bool saveSummary;
+
+    float timeStep;
+    float duration;
+    unsigned int seed;
+
+    //threads updating one simulation
+    int workers;
+
+    //car following kernel, the best one of this CPU by default
+    CarFollowing::Isa kernel;
+    bool deterministic;
+
+    //vehicles with nothing to do are skipped, see VehicleStore::updateDriving
+    bool sleeping;
+
+    //car following of freely driving vehicles every 2^maxRate ticks at most
+    int maxRate;
+
+    //processes updating one simulation - host of every node, this node's number
+    //and the port of the first node; a single process when there are no hosts
+    std::vector<std::string> hosts;
+    int node;
+    int port;
+
+    BatchConfig();
+};
+
+//Runs the simulation without any window with a fixed time step until the given
+//simulated duration is reached, as fast as the CPU allows
+
+class BatchRunner
+{
+public:
+    BatchRunner(const BatchConfig &batchConfig, const bool verboseRun = true);
+
+    void run();
+
+    long long getTicks() const;
+    long long getVehicleUpdates() const;
+    double getSimulatedTime() const;
+    double getWallTime() const;
+
+private:
+    BatchConfig config;
+    bool verbose;
+
+    int nodes;
+
+    long long ticks;
+    long long vehicleUpdates;
+    long long awakeUpdates;
+    long long coastingUpdates;
+    double simulatedTime;
+    double wallTime;
+
+    void gatherResults(Cluster &cluster);
+    void createDirectory(const std::string dirName) const;
+    void printSummary(std::ostream &out) const;
+    void writeSummary() const;
+};
+
+#endif // BATCHRUNNER_H
@@ -0,0 +1,287 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Benchmark.cpp
+
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "Benchmark.h"
+#include "Simulation.h"
+#include "BatchRunner.h"
+#include "CarFollowing.h"
+using namespace std;
+
+void Benchmark::run(const string name)
+{
+    if (name.compare("registry") == 0) registry();
+    else if (name.compare("vehicles") == 0) vehicles();
+    else if (name.compare("following") == 0) following();
+    else if (name.compare("multirate") == 0) multirate();
+    else throw ExceptionClass("unknown benchmark " + name);
+}
+
+void Benchmark::printNames()
+{
+    cout << "  registry  - cost of destroying and registering an object" << endl;
+    cout << "  vehicles  - vehicle updates per second on the example map" << endl;
+    cout << "  following - car following kernel with every instruction set" << endl;
+    cout << "  multirate - example and arterial maps with every maximal coasting rate" << endl;
+}
+
+//Despawns an object and registers it again, with 1k up to 1M objects registered.
+//Objects are despawned oldest first, like vehicles leaving the map, and in random
+//order; the cost per despawn must not depend on the number of objects (in random
+//order it only grows with cache misses once the objects stop fitting in cache).
+
+void Benchmark::registry()
+{
+    const int OPERATIONS = 200000;
+
+    cout << setw(12) << "objects" << setw(24) << "ns/despawn oldest first" << setw(20) << "ns/despawn random" << endl;
+
+    for (int objectsNumber = 1000; objectsNumber <= 1000000; objectsNumber *= 10)
+    {
+        Simulation simulation;
+        vector<GameObject*> all;
+        all.reserve(objectsNumber);
+
+        for (int i = 0; i < objectsNumber; i++)
+        {
+            GameObject *go = new GameObject(&simulation);
+            all.push_back(go);
+            simulation.registerObject(go);
+        }
+
+        RandomStream random(1, 0);
+        vector<int> orders[2];
+
+        for (int i = 0; i < OPERATIONS; i++)
+        {
+            orders[0].push_back(i % objectsNumber);
+            orders[1].push_back(random.nextInt(0, objectsNumber - 1));
+        }
+
+        cout << setw(12) << objectsNumber;
+
+        for (int k = 0; k < 2; k++)
+        {
+            chrono::steady_clock::time_point begTime = chrono::steady_clock::now();
+
+            for (const auto &o : orders[k])
+            {
+                simulation.destroyObject(all[o]);
+                simulation.registerObject(all[o]);
+            }
+
+            chrono::steady_clock::time_point endTime = chrono::steady_clock::now();
+            double ns = chrono::duration<double, nano>(endTime - begTime).count() / OPERATIONS;
+
+            cout << setw(k == 0 ? 24 : 20) << fixed << setprecision(1) << ns;
+        }
+
+        cout << endl;
+    }
+}
+
+//One simulated hour of the example map, best of a few runs
+
+void Benchmark::vehicles()
+{
+    const int RUNS = 5;
+
+    BatchConfig config;
+    config.duration = 3600;
+    config.saveSummary = false;
+
+    double best = 0;
+
+    for (int i = 0; i < RUNS; i++)
+    {
+        BatchRunner runner(config, false);
+        runner.run();
+
+        double updatesPerSecond = runner.getVehicleUpdates() / runner.getWallTime();
+        if (updatesPerSecond > best) best = updatesPerSecond;
+
+        cout << "run " << i + 1 << ": " << fixed << setprecision(0) << updatesPerSecond << " vehicle updates/s" << endl;
+    }
+
+    cout << "best:  " << fixed << setprecision(0) << best << " vehicle updates/s" << endl;
+}
+
+//Car following kernel on a batch of random vehicles the size of a busy region, with
+//every instruction set supported by the CPU, in the deterministic and fast mode.
+//Results of the deterministic kernels must not differ from the scalar ones at all.
+
+void Benchmark::following()
+{
+    const int VEHICLES = 4096;
+    const int REPEATS = 2000;
+    const float DELTA = 0.02;
+
+    CarFollowing::Batch batch;
+    batch.reserve(VEHICLES);
+
+    RandomStream random(1, 0);
+
+    for (int i = 0; i < VEHICLES; i++)
+    {
+        batch.gap[i] = random.nextFloat(-0.5, 10);
+        batch.prevVelocity[i] = random.nextFloat(0, 1.5);
+        batch.vehicleLength[i] = random.nextFloat(0.2, 0.5);
+        batch.remainDst[i] = random.nextFloat(0.06, 0.08);
+        batch.acceleration[i] = random.nextFloat(0.1, 0.2);
+        batch.stopTime[i] = random.nextFloat(0.5, 0.8);
+        batch.minV[i] = random.nextFloat(0.02, 0.08);
+        batch.maxV[i] = random.nextFloat(1, 1.5);
+    }
+
+    batch.setKernel(CarFollowing::SCALAR, true);
+    CarFollowing::compute(batch, VEHICLES, DELTA);
+
+    const vector<float> scalarVelocity(batch.velocity.begin(), batch.velocity.begin() + VEHICLES);
+    const vector<unsigned char> scalarBraking(batch.braking.begin(), batch.braking.begin() + VEHICLES);
+
+    double scalarNs = 0;
+
+    cout << setw(8) << "kernel" << setw(16) << "mode" << setw(14) << "ns/vehicle" << setw(10) << "speedup" << setw(14) << "differences" << endl;
+
+    for (int k = 0; k < CarFollowing::ISAS; k++)
+    {
+        const CarFollowing::Isa isa = (CarFollowing::Isa)k;
+        if (!CarFollowing::isSupported(isa)) continue;
+
+        for (int mode = 0; mode < 2; mode++)
+        {
+            if (isa == CarFollowing::SCALAR && mode == 1) continue;
+
+            batch.setKernel(isa, mode == 0);
+
+            chrono::steady_clock::time_point begTime = chrono::steady_clock::now();
+
+            for (int r = 0; r < REPEATS; r++)
+            {
+                CarFollowing::compute(batch, VEHICLES, DELTA);
+            }
+
+            chrono::steady_clock::time_point endTime = chrono::steady_clock::now();
+            double ns = chrono::duration<double, nano>(endTime - begTime).count() / REPEATS / VEHICLES;
+
+            if (isa == CarFollowing::SCALAR) scalarNs = ns;
+
+            int differences = 0;
+            for (int i = 0; i < VEHICLES; i++)
+            {
+                if (batch.velocity[i] != scalarVelocity[i] || batch.braking[i] != scalarBraking[i]) differences++;
+            }
+
+            cout << setw(8) << CarFollowing::getIsaName(isa) << setw(16) << (mode == 0 ? "deterministic" : "fast");
+            cout << setw(14) << fixed << setprecision(3) << ns << setw(9) << setprecision(2) << scalarNs / ns << "x" << setw(14) << differences << endl;
+        }
+    }
+}
+
+//Twenty simulated minutes of the example map and of a network of long arterial
+//streets in free flow, with every maximal rate of the car following; best of a few
+//runs. Positions and velocities of all vehicles are sampled every simulated second
+//and compared with the ones of rate 0, which computes every vehicle in every tick;
+//coasting only skips computations whose result is known, so the largest
+//differences must be 0.
+
+void Benchmark::multirate()
+{
+    const int RUNS = 3;
+    const int SAMPLE_TICKS = 50;
+    const float DURATION = 1200;
+
+    const string maps[][2] = {{"exampleRoad.txt", "exampleRightOfWay.txt"}, {"arterialRoad.txt", "arterialRightOfWay.txt"}};
+
+    const BatchConfig config;
+    const long long ticksToRun = (long long)ceil(DURATION / config.timeStep);
+
+    for (const auto &map : maps)
+    {
+        vector<float> referenceX;
+        vector<float> referenceV;
+        double referenceTime = 0;
+
+        cout << map[0] << endl;
+        cout << setw(6) << "rate" << setw(12) << "wall s" << setw(14) << "coasting %" << setw(10) << "speedup";
+        cout << setw(14) << "max |dx|" << setw(14) << "max |dv|" << endl;
+
+        for (int rate = 0; rate <= VehicleStore::MAX_RATE; rate++)
+        {
+            double best = 0;
+            double coastingShare = 0;
+            float maxDx = 0;
+            float maxDv = 0;
+
+            for (int run = 0; run < RUNS; run++)
+            {
+                Simulation simulation(config.seed);
+                simulation.setVerbose(false);
+                simulation.loadRoad(map[0]);
+                simulation.loadRightOfWay(map[1]);
+
+                VehicleStore &store = simulation.getVehicleStore();
+                store.setMaxRate(rate);
+                long long updates = 0;
+                long long coasting = 0;
+                unsigned int sample = 0;
+
+                chrono::steady_clock::time_point begTime = chrono::steady_clock::now();
+
+                for (long long tick = 0; tick < ticksToRun; tick++)
+                {
+                    updates += simulation.getVehiclesCount();
+                    simulation.step(config.timeStep);
+                    coasting += store.getCoastingCount();
+
+                    if (tick % SAMPLE_TICKS != 0) continue;
+
+                    //the first run of rate 0 is the reference
+                    for (unsigned int i = 0; i < store.xPos.size(); i++, sample++)
+                    {
+                        if (rate == 0 && run == 0)
+                        {
+                            referenceX.push_back(store.xPos[i]);
+                            referenceV.push_back(store.velocity[i]);
+                        }
+                        else if (sample < referenceX.size())
+                        {
+                            maxDx = max(maxDx, fabs(store.xPos[i] - referenceX[sample]));
+                            maxDv = max(maxDv, fabs(store.velocity[i] - referenceV[sample]));
+                        }
+                    }
+                }
+
+                chrono::steady_clock::time_point endTime = chrono::steady_clock::now();
+                double wallTime = chrono::duration<double>(endTime - begTime).count();
+
+                //vehicles missing in either run can't be compared at all
+                if (sample != referenceX.size()) maxDx = maxDv = INFINITY;
+
+                if (run == 0 || wallTime < best) best = wallTime;
+                coastingShare = 100.0 * coasting / max(updates, 1LL);
+            }
+
+            if (rate == 0) referenceTime = best;
+
+            cout << setw(6) << rate << setw(12) << fixed << setprecision(3) << best << setw(14) << setprecision(1) << coastingShare;
+            cout << setw(9) << setprecision(2) << referenceTime / best << "x" << setw(14) << setprecision(6) << maxDx << setw(14) << maxDv << endl;
+        }
+
+        cout << endl;
+    }
+}
@@ -0,0 +1,35 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Benchmark.h
+
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+
+#include "EngineCore/ExceptionClass.h"
+
+//Microbenchmarks of the simulation internals, run from the command line with
+//--benchmark NAME; every benchmark prints its own table
+
+class Benchmark
+{
+public:
+    static void run(const std::string name);
+    static void printNames();
+
+private:
+    static void registry();
+    static void vehicles();
+    static void following();
+    static void multirate();
+};
+
+#endif // BENCHMARK_H
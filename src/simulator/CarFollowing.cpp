@@ -0,0 +1,351 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: CarFollowing.cpp
+
+
+#include "CarFollowing.h"
+
+#include <cstring>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CARFOLLOWING_SIMD
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+//Velocity which lets the vehicle stop within the gap, less its remaining distance,
+//in stopTime with the given deceleration. Braking is signalled when the velocity
+//drops fast or below the minimal one, which stops the vehicle.
+
+static void followScalar(CarFollowing::Batch &b, const int beg, const int end, const float delta)
+{
+    for (int i = beg; i < end; i++)
+    {
+        const float stopTime = b.stopTime[i];
+        const float posDiff = b.gap[i] - b.vehicleLength[i] * 0.5f - b.remainDst[i];
+
+        float v = (posDiff - b.acceleration[i] * stopTime * stopTime * 0.5f) / stopTime;
+        unsigned char braking = (v - b.prevVelocity[i]) / delta < -0.3f;
+
+        if (v < b.minV[i])
+        {
+            v = 0;
+            braking = 1;
+        }
+
+        if (v > b.maxV[i]) v = b.maxV[i];
+
+        b.velocity[i] = v;
+        b.braking[i] = braking;
+    }
+}
+
+#ifdef CARFOLLOWING_SIMD
+
+//Bytes 0 or 1 for the 8 bits of a comparison mask, to store 8 braking flags at once
+struct MaskBytes
+{
+    uint64_t bytes[256];
+
+    MaskBytes()
+    {
+        for (int m = 0; m < 256; m++)
+        {
+            unsigned char flags[8];
+            for (int k = 0; k < 8; k++) flags[k] = (m >> k) & 1;
+
+            memcpy(&bytes[m], flags, 8);
+        }
+    }
+
+    void store(unsigned char *out, const int mask) const
+    {
+        memcpy(out, &bytes[mask & 0xff], 8);
+    }
+};
+
+static const MaskBytes maskBytes;
+
+//Vector kernels do the operations of followScalar one to one; the remainder of the
+//batch is left to it
+
+__attribute__((target("avx2")))
+static void followAvx2(CarFollowing::Batch &b, const int beg, const int end, const float delta)
+{
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 limit = _mm256_set1_ps(-0.3f);
+    const __m256 deltas = _mm256_set1_ps(delta);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = beg;
+
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256 stopTime = _mm256_loadu_ps(&b.stopTime[i]);
+        const __m256 maxV = _mm256_loadu_ps(&b.maxV[i]);
+
+        __m256 posDiff = _mm256_sub_ps(_mm256_loadu_ps(&b.gap[i]), _mm256_mul_ps(_mm256_loadu_ps(&b.vehicleLength[i]), half));
+        posDiff = _mm256_sub_ps(posDiff, _mm256_loadu_ps(&b.remainDst[i]));
+
+        __m256 stopDst = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(&b.acceleration[i]), stopTime), stopTime), half);
+        __m256 v = _mm256_div_ps(_mm256_sub_ps(posDiff, stopDst), stopTime);
+
+        __m256 braking = _mm256_cmp_ps(_mm256_div_ps(_mm256_sub_ps(v, _mm256_loadu_ps(&b.prevVelocity[i])), deltas), limit, _CMP_LT_OQ);
+
+        const __m256 tooSlow = _mm256_cmp_ps(v, _mm256_loadu_ps(&b.minV[i]), _CMP_LT_OQ);
+        v = _mm256_blendv_ps(v, zero, tooSlow);
+        braking = _mm256_or_ps(braking, tooSlow);
+
+        v = _mm256_blendv_ps(v, maxV, _mm256_cmp_ps(v, maxV, _CMP_GT_OQ));
+
+        _mm256_storeu_ps(&b.velocity[i], v);
+
+        maskBytes.store(&b.braking[i], _mm256_movemask_ps(braking));
+    }
+
+    followScalar(b, i, end, delta);
+}
+
+__attribute__((target("avx512f")))
+static void followAvx512(CarFollowing::Batch &b, const int beg, const int end, const float delta)
+{
+    const __m512 half = _mm512_set1_ps(0.5f);
+    const __m512 limit = _mm512_set1_ps(-0.3f);
+    const __m512 deltas = _mm512_set1_ps(delta);
+    const __m512 zero = _mm512_setzero_ps();
+
+    int i = beg;
+
+    for (; i + 16 <= end; i += 16)
+    {
+        const __m512 stopTime = _mm512_loadu_ps(&b.stopTime[i]);
+        const __m512 maxV = _mm512_loadu_ps(&b.maxV[i]);
+
+        __m512 posDiff = _mm512_sub_ps(_mm512_loadu_ps(&b.gap[i]), _mm512_mul_ps(_mm512_loadu_ps(&b.vehicleLength[i]), half));
+        posDiff = _mm512_sub_ps(posDiff, _mm512_loadu_ps(&b.remainDst[i]));
+
+        __m512 stopDst = _mm512_mul_ps(_mm512_mul_ps(_mm512_mul_ps(_mm512_loadu_ps(&b.acceleration[i]), stopTime), stopTime), half);
+        __m512 v = _mm512_div_ps(_mm512_sub_ps(posDiff, stopDst), stopTime);
+
+        __mmask16 braking = _mm512_cmp_ps_mask(_mm512_div_ps(_mm512_sub_ps(v, _mm512_loadu_ps(&b.prevVelocity[i])), deltas), limit, _CMP_LT_OQ);
+
+        const __mmask16 tooSlow = _mm512_cmp_ps_mask(v, _mm512_loadu_ps(&b.minV[i]), _CMP_LT_OQ);
+        v = _mm512_mask_blend_ps(tooSlow, v, zero);
+        braking |= tooSlow;
+
+        v = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(v, maxV, _CMP_GT_OQ), v, maxV);
+
+        _mm512_storeu_ps(&b.velocity[i], v);
+
+        maskBytes.store(&b.braking[i], braking);
+        maskBytes.store(&b.braking[i + 8], braking >> 8);
+    }
+
+    followScalar(b, i, end, delta);
+}
+
+//Fast variants - fused multiply-add, division by the stop time replaced by its
+//refined reciprocal and the braking test by a multiplication; results differ from
+//the scalar ones in the last bits
+
+__attribute__((target("avx2,fma")))
+static void followAvx2Fast(CarFollowing::Batch &b, const int beg, const int end, const float delta)
+{
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 limit = _mm256_set1_ps(-0.3f * delta);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = beg;
+
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256 stopTime = _mm256_loadu_ps(&b.stopTime[i]);
+        const __m256 maxV = _mm256_loadu_ps(&b.maxV[i]);
+
+        __m256 inverse = _mm256_rcp_ps(stopTime);
+        inverse = _mm256_mul_ps(inverse, _mm256_fnmadd_ps(stopTime, inverse, two));
+
+        __m256 posDiff = _mm256_fnmadd_ps(_mm256_loadu_ps(&b.vehicleLength[i]), half, _mm256_loadu_ps(&b.gap[i]));
+        posDiff = _mm256_sub_ps(posDiff, _mm256_loadu_ps(&b.remainDst[i]));
+
+        const __m256 halfStop = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(&b.acceleration[i]), stopTime), half);
+        __m256 v = _mm256_fmsub_ps(posDiff, inverse, halfStop);
+
+        __m256 braking = _mm256_cmp_ps(_mm256_sub_ps(v, _mm256_loadu_ps(&b.prevVelocity[i])), limit, _CMP_LT_OQ);
+
+        const __m256 tooSlow = _mm256_cmp_ps(v, _mm256_loadu_ps(&b.minV[i]), _CMP_LT_OQ);
+        v = _mm256_blendv_ps(v, zero, tooSlow);
+        braking = _mm256_or_ps(braking, tooSlow);
+
+        v = _mm256_min_ps(v, maxV);
+
+        _mm256_storeu_ps(&b.velocity[i], v);
+
+        maskBytes.store(&b.braking[i], _mm256_movemask_ps(braking));
+    }
+
+    followScalar(b, i, end, delta);
+}
+
+__attribute__((target("avx512f")))
+static void followAvx512Fast(CarFollowing::Batch &b, const int beg, const int end, const float delta)
+{
+    const __m512 half = _mm512_set1_ps(0.5f);
+    const __m512 two = _mm512_set1_ps(2.0f);
+    const __m512 limit = _mm512_set1_ps(-0.3f * delta);
+    const __m512 zero = _mm512_setzero_ps();
+    const __mmask16 ALL = 0xffff;
+
+    int i = beg;
+
+    for (; i + 16 <= end; i += 16)
+    {
+        const __m512 stopTime = _mm512_loadu_ps(&b.stopTime[i]);
+        const __m512 maxV = _mm512_loadu_ps(&b.maxV[i]);
+
+        //masked forms with an explicit source, the plain ones merge into an undefined vector
+        __m512 inverse = _mm512_mask_rcp14_ps(zero, ALL, stopTime);
+        inverse = _mm512_mul_ps(inverse, _mm512_fnmadd_ps(stopTime, inverse, two));
+
+        __m512 posDiff = _mm512_fnmadd_ps(_mm512_loadu_ps(&b.vehicleLength[i]), half, _mm512_loadu_ps(&b.gap[i]));
+        posDiff = _mm512_sub_ps(posDiff, _mm512_loadu_ps(&b.remainDst[i]));
+
+        const __m512 halfStop = _mm512_mul_ps(_mm512_mul_ps(_mm512_loadu_ps(&b.acceleration[i]), stopTime), half);
+        __m512 v = _mm512_fmsub_ps(posDiff, inverse, halfStop);
+
+        __mmask16 braking = _mm512_cmp_ps_mask(_mm512_sub_ps(v, _mm512_loadu_ps(&b.prevVelocity[i])), limit, _CMP_LT_OQ);
+
+        const __mmask16 tooSlow = _mm512_cmp_ps_mask(v, _mm512_loadu_ps(&b.minV[i]), _CMP_LT_OQ);
+        v = _mm512_mask_blend_ps(tooSlow, v, zero);
+        braking |= tooSlow;
+
+        v = _mm512_mask_min_ps(zero, ALL, v, maxV);
+
+        _mm512_storeu_ps(&b.velocity[i], v);
+
+        maskBytes.store(&b.braking[i], braking);
+        maskBytes.store(&b.braking[i + 8], braking >> 8);
+    }
+
+    followScalar(b, i, end, delta);
+}
+
+#endif // CARFOLLOWING_SIMD
+
+CarFollowing::Batch::Batch()
+{
+    isa = findBestIsa();
+    deterministic = true;
+    kernel = selectKernel(isa, deterministic);
+}
+
+void CarFollowing::Batch::reserve(const int size)
+{
+    if (size <= capacity()) return;
+
+    int newSize = capacity() > 0 ? capacity() : 64;
+    while (newSize < size) newSize *= 2;
+
+    gap.resize(newSize);
+    prevVelocity.resize(newSize);
+    vehicleLength.resize(newSize);
+    remainDst.resize(newSize);
+    acceleration.resize(newSize);
+    stopTime.resize(newSize, 1);
+    minV.resize(newSize);
+    maxV.resize(newSize);
+
+    velocity.resize(newSize);
+    braking.resize(newSize);
+}
+
+int CarFollowing::Batch::capacity() const
+{
+    return gap.size();
+}
+
+bool CarFollowing::Batch::setKernel(const Isa newIsa, const bool isDeterministic)
+{
+    if (!isSupported(newIsa)) return false;
+
+    isa = newIsa;
+    deterministic = isDeterministic;
+    kernel = selectKernel(isa, deterministic);
+
+    return true;
+}
+
+CarFollowing::Isa CarFollowing::Batch::getIsa() const
+{
+    return isa;
+}
+
+bool CarFollowing::Batch::isDeterministic() const
+{
+    return deterministic;
+}
+
+void CarFollowing::compute(Batch &batch, const int count, const float delta)
+{
+    batch.kernel(batch, 0, count, delta);
+}
+
+CarFollowing::Isa CarFollowing::findBestIsa()
+{
+    if (isSupported(AVX512)) return AVX512;
+    if (isSupported(AVX2)) return AVX2;
+
+    return SCALAR;
+}
+
+CarFollowing::Kernel CarFollowing::selectKernel(const Isa isa, const bool deterministic)
+{
+#ifdef CARFOLLOWING_SIMD
+    if (isa == AVX512) return deterministic ? followAvx512 : followAvx512Fast;
+
+    if (isa == AVX2)
+    {
+        if (!deterministic && __builtin_cpu_supports("fma")) return followAvx2Fast;
+        return followAvx2;
+    }
+#endif // CARFOLLOWING_SIMD
+
+    return followScalar;
+}
+
+bool CarFollowing::isSupported(const Isa checkedIsa)
+{
+#ifdef CARFOLLOWING_SIMD
+    __builtin_cpu_init();
+
+    if (checkedIsa == AVX512) return __builtin_cpu_supports("avx512f");
+    if (checkedIsa == AVX2) return __builtin_cpu_supports("avx2");
+#endif // CARFOLLOWING_SIMD
+
+    return checkedIsa == SCALAR;
+}
+
+const char* CarFollowing::getIsaName(const Isa nameIsa)
+{
+    static const char *names[ISAS] = {"scalar", "avx2", "avx512"};
+    return names[nameIsa];
+}
+
+CarFollowing::Isa CarFollowing::findIsa(const string name)
+{
+    for (int i = 0; i < ISAS; i++)
+    {
+        if (name.compare(getIsaName((Isa)i)) == 0) return (Isa)i;
+    }
+
+    return ISAS;
+}
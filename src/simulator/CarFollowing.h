@@ -0,0 +1,90 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: CarFollowing.h
+
+
+#ifndef CARFOLLOWING_H
+#define CARFOLLOWING_H
+
+#include <vector>
+#include <string>
+
+//Car following kernel - new velocity and braking flag of every vehicle of a batch
+//from the gap ahead of it. Inputs and outputs are contiguous arrays, so the batch
+//is computed 8 (AVX2) or 16 (AVX-512) vehicles at once when the CPU allows it.
+//
+//In the deterministic mode (default) every instruction set does exactly the same
+//float operations in the same order, so the results are bit-identical to the
+//scalar code. The fast mode uses fused multiply-add and approximate division.
+//The kernel is chosen for every batch, so simulations of one process may use
+//different ones.
+
+class CarFollowing
+{
+public:
+    enum Isa
+    {
+        SCALAR,
+        AVX2,
+        AVX512,
+        ISAS
+    };
+
+    struct Batch;
+    typedef void (*Kernel)(Batch &batch, const int beg, const int end, const float delta);
+
+    struct Batch
+    {
+        //best instruction set of this CPU, deterministic
+        Batch();
+
+        //free distance ahead of the vehicle after moving - to the back of its
+        //leader or to the end of the lane
+        std::vector<float> gap;
+        std::vector<float> prevVelocity;
+        std::vector<float> vehicleLength;
+        std::vector<float> remainDst;
+        std::vector<float> acceleration;
+        std::vector<float> stopTime;
+        std::vector<float> minV;
+        std::vector<float> maxV;
+
+        std::vector<float> velocity;
+        std::vector<unsigned char> braking;
+
+        //makes room for at least size vehicles, never shrinks
+        void reserve(const int size);
+        int capacity() const;
+
+        //false, keeping the current kernel, if the CPU doesn't support the set
+        bool setKernel(const Isa newIsa, const bool isDeterministic);
+        Isa getIsa() const;
+        bool isDeterministic() const;
+
+    private:
+        Isa isa;
+        bool deterministic;
+        Kernel kernel;
+
+        friend class CarFollowing;
+    };
+
+    //first count vehicles of the batch, with its kernel
+    static void compute(Batch &batch, const int count, const float delta);
+
+    static Isa findBestIsa();
+    static bool isSupported(const Isa isa);
+    static const char* getIsaName(const Isa isa);
+    static Isa findIsa(const std::string name);
+
+private:
+    static Kernel selectKernel(const Isa isa, const bool deterministic);
+};
+
+#endif // CARFOLLOWING_H
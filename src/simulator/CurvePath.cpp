@@ -0,0 +1,119 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: CurvePath.cpp
+
+
+#include "CurvePath.h"
+using namespace std;
+
+CurvePath::CurvePath()
+{
+    length = 0;
+
+    for (int k = 0; k <= SEGMENTS; k++)
+    {
+        param[k] = (float)k / SEGMENTS;
+    }
+}
+
+//Control point is where the entry lane and the exit lane would meet, found in the
+//XZ plane. A segment is used when they don't meet in front of the vehicle.
+
+void CurvePath::build(const Vec3 &beg, const Vec3 &end, const Vec3 &begDirection, const Vec3 &endDirection)
+{
+    p0 = beg;
+    p2 = end;
+    p1 = Vec3::lerp(beg, end, 0.5);
+
+    Vec3 w = end - beg;
+    float det = begDirection.x * endDirection.z - begDirection.z * endDirection.x;
+
+    if (fabs(det) > 1e-3)
+    {
+        float a = (w.x * endDirection.z - w.z * endDirection.x) / det;
+        float b = (begDirection.x * w.z - begDirection.z * w.x) / det;
+
+        if (a > 0 && b > 0)
+        {
+            p1 = beg + begDirection * a;
+            p1.y = (beg.y + end.y) / 2.0;
+        }
+    }
+
+    //arc length measured on a fine polyline, then inverted into the coarse table
+    const int SAMPLES = SEGMENTS * 8;
+    float dst[SAMPLES + 1];
+
+    dst[0] = 0;
+    Vec3 prev = p0;
+
+    for (int i = 1; i <= SAMPLES; i++)
+    {
+        Vec3 cur = evaluate((float)i / SAMPLES);
+        dst[i] = dst[i - 1] + Vec3::dst(prev, cur);
+        prev = cur;
+    }
+
+    length = dst[SAMPLES];
+
+    int i = 0;
+    for (int k = 0; k <= SEGMENTS; k++)
+    {
+        float target = length * k / SEGMENTS;
+
+        while (i < SAMPLES - 1 && dst[i + 1] < target) i++;
+
+        float part = dst[i + 1] - dst[i];
+        float t = part > 0 ? (target - dst[i]) / part : 0;
+        if (t > 1) t = 1;
+
+        param[k] = (i + t) / SAMPLES;
+    }
+
+    param[0] = 0;
+    param[SEGMENTS] = 1;
+}
+
+float CurvePath::getLength() const
+{
+    return length;
+}
+
+float CurvePath::getParam(float s) const
+{
+    if (s < 0) s = 0;
+    if (s > 1) s = 1;
+
+    float f = s * SEGMENTS;
+    int k = (int)f;
+    if (k >= SEGMENTS) k = SEGMENTS - 1;
+
+    return param[k] + (param[k + 1] - param[k]) * (f - k);
+}
+
+Vec3 CurvePath::evaluate(const float u) const
+{
+    float v = 1 - u;
+    return p0 * (v * v) + p1 * (2 * u * v) + p2 * (u * u);
+}
+
+Vec3 CurvePath::getPoint(const float s) const
+{
+    return evaluate(getParam(s));
+}
+
+float CurvePath::getHeading(const float s) const
+{
+    float u = getParam(s);
+
+    Vec3 tangent = (p1 - p0) * (1 - u) + (p2 - p1) * u;
+    if (tangent.x == 0 && tangent.z == 0) tangent = p2 - p0;
+
+    return tangent.angleXZ();
+}
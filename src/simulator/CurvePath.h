@@ -0,0 +1,48 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: CurvePath.h
+
+
+#ifndef CURVEPATH_H
+#define CURVEPATH_H
+
+#include "EngineCore/Vec3.h"
+
+//Path of a vehicle through an intersection - quadratic Bezier curve compiled once
+//into a table of curve parameters at equal arc length steps, so a point at a given
+//progress is found by a table lookup and moves with constant speed along the curve.
+//Without a proper corner (going straight, parallel lanes) the path is a segment.
+
+class CurvePath
+{
+public:
+    CurvePath();
+
+    void build(const Vec3 &beg, const Vec3 &end, const Vec3 &begDirection, const Vec3 &endDirection);
+
+    float getLength() const;
+
+    //s - progress along the path, 0 - beginning, 1 - end
+    Vec3 getPoint(const float s) const;
+    float getHeading(const float s) const;
+
+    static const int SEGMENTS = 8;
+
+private:
+    Vec3 p0, p1, p2;
+    float length;
+
+    //curve parameter at every 1/SEGMENTS of the length
+    float param[SEGMENTS + 1];
+
+    float getParam(float s) const;
+    Vec3 evaluate(const float u) const;
+};
+
+#endif // CURVEPATH_H
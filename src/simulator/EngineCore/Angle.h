@@ -0,0 +1,101 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Angle.h
+
+
+#ifndef ANGLE_H
+#define ANGLE_H
+
+#include <cmath>
+
+//Angles in degrees. Wrapping takes a truncation and three selects instead of loops,
+//so it costs the same for any angle and the batch versions vectorize; for angles
+//within one turn of the range it gives the same result as adding or subtracting 360.
+
+class Angle
+{
+public:
+    //to [0, 360), for angles of less than millions of turns
+    static float wrap(const float a)
+    {
+        //floor of the number of turns; truncation, unlike floor, has a packed
+        //instruction on every x86-64
+        const float turns = a / 360.0f;
+        float whole = (float)(int)turns;
+        whole = whole > turns ? whole - 1.0f : whole;
+
+        float w = a - 360.0f * whole;
+
+        //rounding of the division may put w just outside of the range
+        w = w < 0.0f ? w + 360.0f : w;
+        w = w >= 360.0f ? w - 360.0f : w;
+
+        return w;
+    }
+
+    //difference of headings, as used for the articulation of buses
+    static float diff(const float b, const float e)
+    {
+        float d = wrap(e) - wrap(b);
+
+        d = d > 180 ? 180 - d : d;
+        d = d < -180 ? -180 - d : d;
+
+        return d;
+    }
+
+    //interpolation from a to b the shorter way round; the result is not wrapped
+    static float lerp(const float a, const float b, const float s)
+    {
+        const float wa = wrap(a);
+        const float wb = wrap(b);
+
+        const float diff = std::fabs(wb - wa);
+        const float other = 360 - diff;
+
+        const float shorter = diff < other ? diff : -other;
+        const float sign = wa < wb ? 1.0f : -1.0f;
+
+        return wa + sign * shorter * s;
+    }
+
+    //-1 or 1 for a turn from heading a to heading b, 0 when they are less than 45 apart
+    static int turnDirection(const float a, const float b)
+    {
+        const float wa = wrap(a);
+        const float wb = wrap(b);
+
+        const float diff = std::fabs(wb - wa);
+        const float other = 360 - diff;
+
+        if (diff < 45 || other < 45) return 0;
+
+        const int sign = wa < wb ? -1 : 1;
+        return diff < other ? sign : -sign;
+    }
+
+    //batch versions for the first n angles; out may be the input
+    static void wrap(const float *a, float *out, const int n)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            out[i] = wrap(a[i]);
+        }
+    }
+
+    static void lerp(const float *a, const float *b, const float *s, float *out, const int n)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            out[i] = lerp(a[i], b[i], s[i]);
+        }
+    }
+};
+
+#endif // ANGLE_H
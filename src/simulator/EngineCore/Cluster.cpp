@@ -0,0 +1,345 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Cluster.cpp
+
+
+#include "Cluster.h"
+
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#endif // _WIN32
+
+using namespace std;
+
+Message::Message()
+{
+    readPos = 0;
+}
+
+void Message::clear()
+{
+    data.clear();
+    readPos = 0;
+}
+
+bool Message::atEnd() const
+{
+    return readPos >= data.size();
+}
+
+#ifdef _WIN32
+
+Cluster::Cluster(const int thisNode, const vector<string> &nodeHosts, const int basePort)
+{
+    throw ExceptionClass("distributed simulation is not supported on Windows");
+}
+
+Cluster::~Cluster()
+{
+
+}
+
+void Cluster::exchange(const vector<Message> &out, vector<Message> &in)
+{
+
+}
+
+void Cluster::closeAll()
+{
+
+}
+
+#else
+
+Cluster::Cluster(const int thisNode, const vector<string> &nodeHosts, const int basePort)
+{
+    node = thisNode;
+    hosts = nodeHosts;
+
+    if (node < 0 || node >= (int)hosts.size()) throw ExceptionClass("incorrect node number");
+
+    sockets.assign(hosts.size(), -1);
+
+    int listener = -1;
+    if (node + 1 < (int)hosts.size()) listener = listenOn(basePort + node);
+
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::seconds(CONNECT_TIMEOUT);
+
+    try
+    {
+        //introduce itself to every node before, wait for every node after
+        for (int k = 0; k < node; k++)
+        {
+            sockets[k] = connectTo(hosts[k], basePort + k);
+
+            int32_t id = node;
+            if (send(sockets[k], &id, sizeof(id), 0) != sizeof(id)) throw ExceptionClass("failed to introduce to node " + to_string(k));
+        }
+
+        for (int k = node + 1; k < (int)hosts.size(); k++)
+        {
+            int s = acceptFrom(listener, deadline);
+
+            int32_t id = -1;
+            if (recv(s, &id, sizeof(id), MSG_WAITALL) != sizeof(id) || id <= node || id >= (int)hosts.size() || sockets[id] >= 0)
+            {
+                ::close(s);
+                throw ExceptionClass("unexpected connection");
+            }
+
+            sockets[id] = s;
+        }
+    }
+    catch (ExceptionClass e)
+    {
+        if (listener >= 0) ::close(listener);
+        closeAll();
+        throw;
+    }
+
+    if (listener >= 0) ::close(listener);
+
+    for (auto s : sockets)
+    {
+        if (s < 0) continue;
+
+        int flag = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+    }
+}
+
+Cluster::~Cluster()
+{
+    closeAll();
+}
+
+void Cluster::closeAll()
+{
+    for (auto &s : sockets)
+    {
+        if (s >= 0) ::close(s);
+        s = -1;
+    }
+}
+
+int Cluster::listenOn(const int port) const
+{
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s < 0) throw ExceptionClass("failed to create socket");
+
+    int flag = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    if (::bind(s, (sockaddr*)&address, sizeof(address)) != 0 || listen(s, hosts.size()) != 0)
+    {
+        ::close(s);
+        throw ExceptionClass("failed to listen on port " + to_string(port));
+    }
+
+    //polled with a deadline by acceptFrom
+    fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+
+    return s;
+}
+
+//Next connection of a node after this one; a node that crashed or never started
+//must not make the others wait forever
+int Cluster::acceptFrom(const int listener, const chrono::steady_clock::time_point deadline) const
+{
+    while (true)
+    {
+        const long long remaining = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+
+        if (remaining <= 0)
+        {
+            int k = node + 1;
+            while (k < (int)hosts.size() - 1 && sockets[k] >= 0) k++;
+
+            throw ExceptionClass("node " + to_string(k) + " did not connect");
+        }
+
+        pollfd p;
+        p.fd = listener;
+        p.events = POLLIN;
+        p.revents = 0;
+
+        int ready = poll(&p, 1, (int)remaining);
+        if (ready < 0 && errno != EINTR) throw ExceptionClass("failed to wait for other nodes");
+        if (ready <= 0) continue;
+
+        int s = accept(listener, NULL, NULL);
+        if (s < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) continue;
+            throw ExceptionClass("failed to accept connection");
+        }
+
+        //the introduction is read blocking, but not longer than the time left
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) & ~O_NONBLOCK);
+
+        timeval timeout;
+        timeout.tv_sec = remaining / 1000;
+        timeout.tv_usec = (remaining % 1000) * 1000;
+        setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        return s;
+    }
+}
+
+int Cluster::connectTo(const string &host, const int port) const
+{
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo *found = NULL;
+    if (getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &found) != 0 || found == NULL)
+    {
+        throw ExceptionClass("failed to resolve host " + host);
+    }
+
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::seconds(CONNECT_TIMEOUT);
+
+    //the other node may not listen yet
+    while (true)
+    {
+        int s = socket(AF_INET, SOCK_STREAM, 0);
+        if (s >= 0 && connect(s, found->ai_addr, found->ai_addrlen) == 0)
+        {
+            freeaddrinfo(found);
+            return s;
+        }
+
+        if (s >= 0) ::close(s);
+
+        if (chrono::steady_clock::now() > deadline)
+        {
+            freeaddrinfo(found);
+            throw ExceptionClass("failed to connect to " + host + ":" + to_string(port));
+        }
+
+        this_thread::sleep_for(chrono::milliseconds(20));
+    }
+}
+
+//Every message goes with its length in front. Sending and receiving are interleaved,
+//so big messages can't block two nodes sending to each other.
+
+void Cluster::exchange(const vector<Message> &out, vector<Message> &in)
+{
+    const int n = hosts.size();
+
+    vector<vector<char> > sendBuffers(n);
+    vector<size_t> sent(n, 0);
+    vector<size_t> received(n, 0);
+    vector<uint64_t> lengths(n, 0);
+    vector<bool> lengthKnown(n, false);
+
+    in.assign(n, Message());
+
+    for (int k = 0; k < n; k++)
+    {
+        if (k == node) continue;
+
+        uint64_t length = out[k].data.size();
+        const char *bytes = reinterpret_cast<const char*>(&length);
+
+        sendBuffers[k].assign(bytes, bytes + sizeof(length));
+        sendBuffers[k].insert(sendBuffers[k].end(), out[k].data.begin(), out[k].data.end());
+
+        in[k].data.resize(sizeof(uint64_t));
+    }
+
+    while (true)
+    {
+        vector<pollfd> waiting;
+
+        for (int k = 0; k < n; k++)
+        {
+            if (k == node) continue;
+
+            short events = 0;
+            if (sent[k] < sendBuffers[k].size()) events |= POLLOUT;
+            if (!lengthKnown[k] || received[k] < in[k].data.size()) events |= POLLIN;
+
+            if (events == 0) continue;
+
+            pollfd p;
+            p.fd = sockets[k];
+            p.events = events;
+            p.revents = 0;
+            waiting.push_back(p);
+        }
+
+        if (waiting.empty()) break;
+
+        if (poll(&waiting[0], waiting.size(), -1) < 0) throw ExceptionClass("failed to wait for other nodes");
+
+        for (auto &p : waiting)
+        {
+            int k = 0;
+            while (sockets[k] != p.fd) k++;
+
+            if (p.revents & POLLOUT)
+            {
+                ssize_t r = send(p.fd, &sendBuffers[k][sent[k]], sendBuffers[k].size() - sent[k], MSG_NOSIGNAL);
+                if (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK) throw ExceptionClass("lost connection to node " + to_string(k));
+                if (r > 0) sent[k] += r;
+            }
+
+            if (p.revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                ssize_t r = recv(p.fd, &in[k].data[received[k]], in[k].data.size() - received[k], 0);
+                if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) throw ExceptionClass("lost connection to node " + to_string(k));
+                if (r > 0) received[k] += r;
+
+                if (!lengthKnown[k] && received[k] == sizeof(uint64_t))
+                {
+                    memcpy(&lengths[k], &in[k].data[0], sizeof(uint64_t));
+                    lengthKnown[k] = true;
+
+                    in[k].data.assign(lengths[k], 0);
+                    received[k] = 0;
+                }
+            }
+        }
+    }
+}
+
+#endif // _WIN32
+
+int Cluster::getNode() const
+{
+    return node;
+}
+
+int Cluster::getNodesNumber() const
+{
+    return hosts.size();
+}
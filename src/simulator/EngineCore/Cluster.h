@@ -0,0 +1,92 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Cluster.h
+
+
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <chrono>
+
+#include "ExceptionClass.h"
+
+//Binary message - values are appended and read back in the same order. Processes
+//of a cluster run the same program, so values are copied as they are in memory.
+
+class Message
+{
+public:
+    Message();
+
+    template <class T>
+    void put(const T &value)
+    {
+        const char *bytes = reinterpret_cast<const char*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <class T>
+    T get()
+    {
+        if (readPos + sizeof(T) > data.size()) throw ExceptionClass("message is too short");
+
+        T value;
+        memcpy(&value, &data[readPos], sizeof(T));
+        readPos += sizeof(T);
+
+        return value;
+    }
+
+    void clear();
+    bool atEnd() const;
+
+    std::vector<char> data;
+
+private:
+    size_t readPos;
+};
+
+//Processes (nodes) running one simulation together. Every node is connected with
+//every other one by a TCP socket; node k listens on basePort + k at hosts[k], it
+//connects to the nodes before it and accepts the nodes after it.
+
+class Cluster
+{
+public:
+    Cluster(const int thisNode, const std::vector<std::string> &nodeHosts, const int basePort);
+    ~Cluster();
+
+    int getNode() const;
+    int getNodesNumber() const;
+
+    //sends out[k] to every other node k and receives in[k] from it; returns when
+    //all messages are delivered, so it is also a barrier of all nodes
+    void exchange(const std::vector<Message> &out, std::vector<Message> &in);
+
+    //time for the other nodes to start listening and to connect, in seconds
+    static const int CONNECT_TIMEOUT = 30;
+
+private:
+    Cluster(const Cluster&);
+    Cluster& operator = (const Cluster&);
+
+    int node;
+    std::vector<std::string> hosts;
+    std::vector<int> sockets;
+
+    int listenOn(const int port) const;
+    int connectTo(const std::string &host, const int port) const;
+    int acceptFrom(const int listener, const std::chrono::steady_clock::time_point deadline) const;
+    void closeAll();
+};
+
+#endif // CLUSTER_H
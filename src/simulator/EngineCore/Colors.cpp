@@ -11,30 +11,18 @@
 
 #include "Colors.h"
 
-Vec3 Colors::getRandomColor()
+const float Colors::colors[Colors::AMOUNT][3] =
 {
-    static Colors *instance;
-    if (instance == nullptr)
-    {
-        instance = new Colors();
-    }
-    return instance->pickRandom();
-}
-
-Colors::Colors()
-{
-    amount = 6;
-    colors = new Vec3[amount];
-
-    colors[0] = Vec3(1, 0, 0);
-    colors[1] = Vec3(0, 1, 0);
-    colors[2] = Vec3(0, 0, 1);
-    colors[3] = Vec3(1, 0, 1);
-    colors[4] = Vec3(1, 1, 0);
-    colors[5] = Vec3(0, 1, 1);
-}
+    {1, 0, 0},
+    {0, 1, 0},
+    {0, 0, 1},
+    {1, 0, 1},
+    {1, 1, 0},
+    {0, 1, 1}
+};
 
-Vec3 Colors::pickRandom()
+Vec3 Colors::getColor(const int which)
 {
-    return colors[rand() % amount];
+    const float *c = colors[which % AMOUNT];
+    return Vec3(c[0], c[1], c[2]);
 }
@@ -12,20 +12,17 @@
 #ifndef COLORS_H
 #define COLORS_H
 
-#include <cstdlib>
 #include "Vec3.h"
 
 class Colors
 {
 public:
-    static Vec3 getRandomColor();
+    static const int AMOUNT = 6;
 
-private:
-    Vec3 *colors;
-    int amount;
-    Colors();
+    static Vec3 getColor(const int which);
 
-    Vec3 pickRandom();
+private:
+    static const float colors[AMOUNT][3];
 };
 
 #endif // COLORS_H
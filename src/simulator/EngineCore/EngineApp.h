@@ -0,0 +1,34 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: EngineApp.h
+
+
+#ifndef ENGINEAPP_H
+#define ENGINEAPP_H
+
+//Application driven by an engine backend (windowed or headless)
+
+class EngineApp
+{
+public:
+    virtual ~EngineApp(){};
+
+    virtual void keyHeld(char k) = 0;
+    virtual void keyPressed(char k) = 0;
+    virtual void update(const float delta) = 0;
+    virtual void singleUpdate(const float delta) = 0;
+
+    //called on the simulation thread after updates, redraw on the window thread
+    //shows the latest published frame
+    virtual void publishFrame() = 0;
+    virtual void redraw() = 0;
+    virtual void mouseMove(const int dx, const int dy) = 0;
+};
+
+#endif // ENGINEAPP_H
@@ -17,4 +17,6 @@
 #include "EngineCoreLinux.h"
 #endif // _WIN32
 
+#include "EngineCoreHeadless.h"
+
 #endif // ENGINECORE_H
@@ -9,32 +9,150 @@
 ///   File: EngineCoreBase.cpp
 
 #include "EngineCoreBase.h"
+using namespace std;
 
-EngineCoreBase::EngineCoreBase() :  MIN_TIME_SCALE(0.25),       MAX_TIME_SCALE(15.0),
+EngineCoreBase::EngineCoreBase(EngineApp *engineApp) :
+                                    MIN_TIME_SCALE(0.25),       MAX_TIME_SCALE(15.0),
                                     MIN_UPDATES_PER_FRAME(1),   MAX_UPDATES_PER_FRAME(1000),
-                                    MIN_DELTA(0.007),           MAX_DELTA(0.15)
+                                    MIN_DELTA(0.007),           MAX_DELTA(0.15),
+                                    TURBO_STEP(0.02),           TURBO_FRAME_TIME(1.0 / 30.0),
+                                    TURBO_HEADLESS_FRAME_TIME(0.25),
+                                    TURBO_REPORT_TIME(5.0),
+                                    RENDER_FRAME_TIME(1.0 / 60.0),
+                                    SIMULATION_FRAME_TIME(1.0 / 60.0)
 {
+    app = engineApp;
+
+    turbo = false;
+    wasTurbo = false;
+    turboSimulatedTime = 0;
+    turboWallTime = 0;
+    turboReportSimulatedTime = 0;
+    turboReportWallTime = 0;
+
     timeScale = 1.2;
     updatesPerFrame = 2;
     goingToUpdateRatio = true;
 
     width = 1280;
     height = 720;
+
+    goingToBreakMainLoop = false;
+    simulationRunning = false;
+    simulationFailed = false;
 }
 
 void EngineCoreBase::run()
 {
+    init();
+
     showWindow();
     goingToBreakMainLoop = false;
 
+    if (isRendering())
+        runPipelined();
+    else
+        runHeadless();
+
+    hideWindow();
+
+    if (turboWallTime > 0) reportTurbo();
+
+    if (simulationFailed) throw ExceptionClass(simulationError);
+}
+
+//Without a window the model is simply stepped on this thread
+void EngineCoreBase::runHeadless()
+{
     while (true)
     {
         checkEvents();
         if (goingToBreakMainLoop) break;
 
-        performFrame(getDeltaTime());
+        simulateFrame(getDeltaTime());
     }
-    hideWindow();
+}
+
+//The model runs on its own thread and publishes frames (see EngineApp::publishFrame),
+//this thread handles the window and the camera and draws the latest published frame,
+//so a slow simulation doesn't slow down the camera and drawing doesn't slow down
+//the simulation
+
+void EngineCoreBase::runPipelined()
+{
+    simulationRunning = true;
+    thread simulation(&EngineCoreBase::simulationLoop, this);
+
+    chrono::steady_clock::time_point nextFrame = chrono::steady_clock::now();
+
+    while (true)
+    {
+        checkEvents();
+        if (goingToBreakMainLoop) break;
+
+        float cameraDelta = getDeltaTime();
+        if (cameraDelta > MAX_DELTA) cameraDelta = MAX_DELTA;
+
+        singleUpdate(cameraDelta);
+        drawFrame();
+
+        nextFrame += chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<float>(RENDER_FRAME_TIME));
+
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        if (nextFrame < now) nextFrame = now;
+        this_thread::sleep_until(nextFrame);
+    }
+
+    simulationRunning = false;
+    simulation.join();
+}
+
+void EngineCoreBase::simulationLoop()
+{
+    const chrono::steady_clock::duration frameTime = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<float>(SIMULATION_FRAME_TIME));
+    chrono::steady_clock::time_point lastTime = chrono::steady_clock::now();
+
+    try
+    {
+        while (simulationRunning)
+        {
+            //real time mode keeps the pace of the frames, turbo mode runs flat out
+            if (!turbo) this_thread::sleep_until(lastTime + frameTime);
+
+            chrono::steady_clock::time_point now = chrono::steady_clock::now();
+            float realDelta = chrono::duration<float>(now - lastTime).count();
+            lastTime = now;
+
+            simulateFrame(realDelta);
+        }
+    }
+    catch (ExceptionClass e)
+    {
+        simulationFailed = true;
+        simulationError = e.what();
+        goingToBreakMainLoop = true;
+    }
+    catch (const exception &e)
+    {
+        simulationFailed = true;
+        simulationError = string("unexpected error: ") + e.what();
+        goingToBreakMainLoop = true;
+    }
+}
+
+void EngineCoreBase::simulateFrame(const float realUnscaledDelta)
+{
+    const bool turboNow = turbo;
+
+    if (wasTurbo && !turboNow && turboWallTime > turboReportWallTime) reportTurbo();
+    wasTurbo = turboNow;
+
+    if (turboNow)
+        performTurboFrame();
+    else
+        performFrame(realUnscaledDelta);
+
+    if (isRendering()) publishFrame();
 }
 
 void EngineCoreBase::performFrame(const float realUnscaledDelta)
@@ -43,14 +161,50 @@ void EngineCoreBase::performFrame(const float realUnscaledDelta)
     if (delta > MAX_DELTA) delta = MAX_DELTA;
     if (delta < MIN_DELTA) delta = MIN_DELTA;
 
-    singleUpdate(delta);
+    const int updates = updatesPerFrame;
 
-    for(int i=0; i < updatesPerFrame; i++)
+    for(int i=0; i < updates; i++)
     {
         update(delta);
     }
+}
+
+void EngineCoreBase::performTurboFrame()
+{
+    //simulate with the fixed step for the whole frame, publish only once per frame
+    const float frameTime = isRendering() ? TURBO_FRAME_TIME : TURBO_HEADLESS_FRAME_TIME;
+
+    chrono::steady_clock::time_point begTime = chrono::steady_clock::now();
+    float elapsed = 0;
+    long long steps = 0;
+
+    while (elapsed < frameTime)
+    {
+        update(TURBO_STEP);
+        steps++;
+
+        elapsed = chrono::duration<float>(chrono::steady_clock::now() - begTime).count();
+    }
 
-    drawFrame();
+    turboSimulatedTime += steps * (double)TURBO_STEP;
+    turboWallTime += elapsed;
+
+    if (turboWallTime - turboReportWallTime >= TURBO_REPORT_TIME) reportTurbo();
+}
+
+void EngineCoreBase::reportTurbo()
+{
+    double wall = turboWallTime - turboReportWallTime;
+    double simulated = turboSimulatedTime - turboReportSimulatedTime;
+
+    if (wall > 0)
+    {
+        cout << "Turbo: simulated " << turboSimulatedTime << " s in " << turboWallTime << " s, ";
+        cout << simulated / wall << " simulated s per wall s" << endl;
+    }
+
+    turboReportWallTime = turboWallTime;
+    turboReportSimulatedTime = turboSimulatedTime;
 }
 
 void EngineCoreBase::updateWindowRatio()
@@ -120,3 +274,75 @@ void EngineCoreBase::breakMainLoop()
 {
     goingToBreakMainLoop = true;
 }
+
+void EngineCoreBase::changeTimeScale(const float d)
+{
+    float newTimeScale = timeScale + d;
+    if (newTimeScale < MIN_TIME_SCALE) newTimeScale = MIN_TIME_SCALE;
+    if (newTimeScale > MAX_TIME_SCALE) newTimeScale = MAX_TIME_SCALE;
+
+    timeScale = newTimeScale;
+}
+
+void EngineCoreBase::changeUpdatesPerFrame(const int d)
+{
+    int newUpdates = updatesPerFrame + d;
+    if (newUpdates < MIN_UPDATES_PER_FRAME) newUpdates = MIN_UPDATES_PER_FRAME;
+    if (newUpdates > MAX_UPDATES_PER_FRAME) newUpdates = MAX_UPDATES_PER_FRAME;
+
+    updatesPerFrame = newUpdates;
+}
+
+//Statistics of a finished turbo period are reported by the simulation loop
+void EngineCoreBase::setTurbo(const bool enabled)
+{
+    if (turbo == enabled) return;
+
+    turbo = enabled;
+    cout << "Turbo mode " << (turbo ? "on" : "off") << endl;
+}
+
+bool EngineCoreBase::isTurbo() const
+{
+    return turbo;
+}
+
+bool EngineCoreBase::isRendering() const
+{
+    return true;
+}
+
+void EngineCoreBase::keyHeld(char k)
+{
+    app->keyHeld(k);
+}
+
+void EngineCoreBase::keyPressed(char k)
+{
+    app->keyPressed(k);
+}
+
+void EngineCoreBase::update(const float delta)
+{
+    app->update(delta);
+}
+
+void EngineCoreBase::singleUpdate(const float delta)
+{
+    app->singleUpdate(delta);
+}
+
+void EngineCoreBase::publishFrame()
+{
+    app->publishFrame();
+}
+
+void EngineCoreBase::redraw()
+{
+    app->redraw();
+}
+
+void EngineCoreBase::mouseMove(const int dx, const int dy)
+{
+    app->mouseMove(dx, dy);
+}
@@ -16,14 +16,32 @@
 
 #include <vector>
 #include <string>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <iostream>
 
 #include "ExceptionClass.h"
+#include "EngineApp.h"
 
 class EngineCoreBase
 {
+public:
+    virtual ~EngineCoreBase(){};
+
+    void run();
+    void breakMainLoop();
+
+    void changeTimeScale(const float d);
+    void changeUpdatesPerFrame(const int d);
+
+    void setTurbo(const bool enabled);
+    bool isTurbo() const;
+
 protected:
-    float timeScale;
-    int updatesPerFrame;
+    //changed by the window thread, read by the simulation thread
+    std::atomic<float> timeScale;
+    std::atomic<int> updatesPerFrame;
 
     const float MIN_TIME_SCALE;
     const float MAX_TIME_SCALE;
@@ -34,39 +52,66 @@ protected:
     const float MIN_DELTA;
     const float MAX_DELTA;
 
-    EngineCoreBase();
-    virtual ~EngineCoreBase(){};
+    //turbo mode: fixed simulation step, simulated time decoupled from frames
+    const float TURBO_STEP;
+    const float TURBO_FRAME_TIME;
+    const float TURBO_HEADLESS_FRAME_TIME;
+    const float TURBO_REPORT_TIME;
+
+    //pace of the window thread and of the simulation thread in real time mode
+    const float RENDER_FRAME_TIME;
+    const float SIMULATION_FRAME_TIME;
+
+    EngineCoreBase(EngineApp *engineApp);
 
     virtual int init() = 0;
 
     void initLight();
     void updateRatio();
-    void breakMainLoop();
-
-    void run();
 
+    virtual bool isRendering() const;
     virtual float getDeltaTime() = 0;
     virtual void checkEvents() = 0;
     virtual void swapBuffers() = 0;
     virtual void showWindow() = 0;
     virtual void hideWindow() = 0;
 
-    virtual void keyHeld(char k) = 0;
-    virtual void keyPressed(char k) = 0;
-    virtual void update(const float delta) = 0;
-    virtual void singleUpdate(const float delta) = 0;
-    virtual void redraw() = 0;
-    virtual void mouseMove(const int dx, const int dy) = 0;
+    void keyHeld(char k);
+    void keyPressed(char k);
+    void update(const float delta);
+    void singleUpdate(const float delta);
+    void publishFrame();
+    void redraw();
+    void mouseMove(const int dx, const int dy);
 
     int width;
     int height;
 
 private:
+    EngineApp *app;
+
     bool goingToUpdateRatio;
-    bool goingToBreakMainLoop;
+    std::atomic<bool> goingToBreakMainLoop;
+
+    std::atomic<bool> turbo;
+    bool wasTurbo;
+    double turboSimulatedTime;
+    double turboWallTime;
+    double turboReportSimulatedTime;
+    double turboReportWallTime;
+
+    std::atomic<bool> simulationRunning;
+    bool simulationFailed;
+    std::string simulationError;
 
     void updateWindowRatio();
+    void runHeadless();
+    void runPipelined();
+    void simulationLoop();
+    void simulateFrame(const float realUnscaledDelta);
     void performFrame(const float realUnscaledDelta);
+    void performTurboFrame();
+    void reportTurbo();
     void drawFrame();
 };
 
@@ -0,0 +1,75 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: EngineCoreHeadless.cpp
+
+#include "EngineCoreHeadless.h"
+using namespace std;
+
+volatile sig_atomic_t EngineCoreHeadless::stopRequested = 0;
+
+EngineCoreHeadless::EngineCoreHeadless(EngineApp *engineApp) : EngineCoreBase(engineApp)
+{
+
+}
+
+int EngineCoreHeadless::init()
+{
+    stopRequested = 0;
+
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+
+    lastTime = chrono::steady_clock::now();
+
+    return 0;
+}
+
+void EngineCoreHeadless::requestStop(int)
+{
+    stopRequested = 1;
+}
+
+bool EngineCoreHeadless::isRendering() const
+{
+    return false;
+}
+
+float EngineCoreHeadless::getDeltaTime()
+{
+    chrono::steady_clock::time_point newTime = chrono::steady_clock::now();
+    float delta = chrono::duration<float>(newTime - lastTime).count();
+
+    lastTime = newTime;
+
+    return delta;
+}
+
+void EngineCoreHeadless::checkEvents()
+{
+    if (stopRequested)
+    {
+        stopRequested = 0;
+        keyPressed(27);
+    }
+}
+
+void EngineCoreHeadless::swapBuffers()
+{
+
+}
+
+void EngineCoreHeadless::showWindow()
+{
+
+}
+
+void EngineCoreHeadless::hideWindow()
+{
+
+}
@@ -0,0 +1,46 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: EngineCoreHeadless.h
+
+#ifndef ENGINECOREHEADLESS_H
+#define ENGINECOREHEADLESS_H
+
+#include <chrono>
+#include <csignal>
+
+#include "EngineCoreBase.h"
+
+//Backend without a window and without OpenGL context - only updates are performed,
+//nothing is drawn. The main loop is stopped by SIGINT/SIGTERM (handled like ESC).
+
+class EngineCoreHeadless : public EngineCoreBase
+{
+public:
+    EngineCoreHeadless(EngineApp *engineApp);
+    virtual ~EngineCoreHeadless(){};
+
+protected:
+    int init();
+
+    bool isRendering() const;
+    float getDeltaTime();
+    void checkEvents();
+    void swapBuffers();
+
+private:
+    void showWindow();
+    void hideWindow();
+
+    std::chrono::steady_clock::time_point lastTime;
+
+    static volatile std::sig_atomic_t stopRequested;
+    static void requestStop(int);
+};
+
+#endif // ENGINECOREHEADLESS_H
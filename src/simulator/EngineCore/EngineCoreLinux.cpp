@@ -24,6 +24,11 @@ void EngineCore::SetCmdArgs(int argC, char **argV)
     argv = argV;
 }
 
+EngineCore::EngineCore(EngineApp *engineApp) : EngineCoreBase(engineApp)
+{
+
+}
+
 int EngineCore::init()
 {
     int snglBuf[] = {GLX_RGBA, GLX_DEPTH_SIZE, 16, None};
@@ -24,12 +24,14 @@
 
 //This class bases on Code::Blocks OpenGL template (OpenGL + X11)
 
-class EngineCore : protected EngineCoreBase
+class EngineCore : public EngineCoreBase
 {
-protected:
+public:
+    EngineCore(EngineApp *engineApp);
+    virtual ~EngineCore(){};
 
+protected:
     int init();
-    virtual ~EngineCore(){};
 
     float getDeltaTime();
     void checkEvents();
@@ -16,6 +16,11 @@
 
 EngineCore *EngineCore::instance = nullptr;
 
+EngineCore::EngineCore(EngineApp *engineApp) : EngineCoreBase(engineApp)
+{
+
+}
+
 int EngineCore::init()
 {
     SetConsoleTitle("City traffic simulation");
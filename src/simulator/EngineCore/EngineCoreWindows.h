@@ -20,12 +20,14 @@
 
 #include "EngineCoreBase.h"
 
-class EngineCore : protected EngineCoreBase
+class EngineCore : public EngineCoreBase
 {
-protected:
+public:
+    EngineCore(EngineApp *engineApp);
+    virtual ~EngineCore(){};
 
+protected:
     int init();
-    virtual ~EngineCore(){};
 
     float getDeltaTime();
     void checkEvents();
@@ -18,10 +18,10 @@ ExceptionClass::ExceptionClass(const char *msg) throw()
 
 ExceptionClass::ExceptionClass(std::string msg) throw()
 {
-    exceptionMsg = msg.c_str();
+    exceptionMsg = msg;
 }
 
 const char *ExceptionClass::what() const throw()
 {
-    return exceptionMsg;
+    return exceptionMsg.c_str();
 }
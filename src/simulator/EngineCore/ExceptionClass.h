@@ -25,7 +25,7 @@ public:
     const char* what() const throw();
 
 private:
-    const char *exceptionMsg;
+    std::string exceptionMsg;
 };
 
 #endif // EXCEPTIONCLASS_H
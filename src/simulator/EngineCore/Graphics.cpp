@@ -138,48 +138,12 @@ float Graphics::lerp(const float a, const float b, const float s) const
 
 float Graphics::lerpAngle(float a, float b, float s) const
 {
-    while (a<0) a+=360;
-    while (b<0) b+=360;
-    while (a>=360) a-=360;
-    while (b>=360) b-=360;
-
-    float diff = abs(b - a);
-    float temp = 360 - diff;
-
-    if (diff < temp)
-    {
-        if (a<b)
-            return a + diff * s;
-        return a - diff * s;
-    }
-
-    if (a<b)
-        return a - temp * s;
-    return a + temp * s;
+    return Angle::lerp(a, b, s);
 }
 
 int Graphics::rotateDirection(float a, float b) const
 {
-    while (a<0) a+=360;
-    while (b<0) b+=360;
-    while (a>=360) a-=360;
-    while (b>=360) b-=360;
-
-    float diff = abs(b - a);
-    float temp = 360 - diff;
-
-    if (diff < 45 || temp < 45) return 0;
-
-    if (diff < temp)
-    {
-        if (a<b)
-            return -1;
-        return 1;
-    }
-
-    if (a<b)
-        return 1;
-    return -1;
+    return Angle::turnDirection(a, b);
 }
 
 void Graphics::beginDraw(const int mode)
@@ -0,0 +1,140 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Random.cpp
+
+
+#include "Random.h"
+
+namespace
+{
+    const uint32_t PHILOX_M0 = 0xD2511F53;
+    const uint32_t PHILOX_M1 = 0xCD9E8D57;
+    const uint32_t PHILOX_W0 = 0x9E3779B9;
+    const uint32_t PHILOX_W1 = 0xBB67AE85;
+    const int PHILOX_ROUNDS = 10;
+}
+
+RandomStream::RandomStream()
+{
+    key[0] = key[1] = 0;
+    counter[0] = counter[1] = counter[2] = counter[3] = 0;
+    used = 4;
+}
+
+RandomStream::RandomStream(const uint64_t seed, const uint64_t streamId)
+{
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+
+    //first half of the counter numbers the blocks, second half selects the stream
+    counter[0] = 0;
+    counter[1] = 0;
+    counter[2] = (uint32_t)streamId;
+    counter[3] = (uint32_t)(streamId >> 32);
+
+    used = 4;
+}
+
+uint64_t RandomStream::makeStreamId(const StreamKind kind, const uint32_t index, const uint32_t serial)
+{
+    return ((uint64_t)kind << 56) | ((uint64_t)(index & 0xFFFFFF) << 32) | serial;
+}
+
+void RandomStream::philox(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int i = 0; i < PHILOX_ROUNDS; i++)
+    {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n1 = (uint32_t)p1;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        uint32_t n3 = (uint32_t)p0;
+
+        c0 = n0; c1 = n1; c2 = n2; c3 = n3;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+void RandomStream::nextBlock()
+{
+    philox(counter, key, block);
+
+    if (++counter[0] == 0) counter[1]++;
+    used = 0;
+}
+
+float RandomStream::toFloat(const uint32_t x)
+{
+    //24 bits - every value is exactly representable, result is in [0, 1)
+    return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+uint32_t RandomStream::nextUInt()
+{
+    if (used == 4) nextBlock();
+    return block[used++];
+}
+
+float RandomStream::nextFloat()
+{
+    return toFloat(nextUInt());
+}
+
+float RandomStream::nextFloat(const float minV, const float maxV)
+{
+    return minV + (maxV - minV) * nextFloat();
+}
+
+int RandomStream::nextInt(const int minV, const int maxV)
+{
+    uint64_t d = (uint64_t)(maxV - minV + 1);
+    return minV + (int)(((uint64_t)nextUInt() * d) >> 32);
+}
+
+void RandomStream::fill(float *out, const int n)
+{
+    int i = 0;
+
+    while (i < n && used < 4)
+        out[i++] = toFloat(block[used++]);
+
+    //whole blocks go straight to the output
+    for (; i + 4 <= n; i += 4)
+    {
+        uint32_t values[4];
+        philox(counter, key, values);
+        if (++counter[0] == 0) counter[1]++;
+
+        out[i]     = toFloat(values[0]);
+        out[i + 1] = toFloat(values[1]);
+        out[i + 2] = toFloat(values[2]);
+        out[i + 3] = toFloat(values[3]);
+    }
+
+    while (i < n)
+        out[i++] = nextFloat();
+}
+
+void RandomStream::fill(float *out, const int n, const float minV, const float maxV)
+{
+    fill(out, n);
+
+    const float d = maxV - minV;
+    for (int i = 0; i < n; i++)
+        out[i] = minV + d * out[i];
+}
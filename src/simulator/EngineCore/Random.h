@@ -0,0 +1,59 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Random.h
+
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+//Counter-based random stream (Philox4x32-10). The n-th number of a stream depends
+//only on the seed, the stream ID and n, so every entity can own its stream and
+//the results do not depend on the order or thread in which entities are updated.
+
+class RandomStream
+{
+public:
+    enum StreamKind
+    {
+        CROSS,
+        GARAGE,
+        VEHICLE,
+
+        STREAM_KINDS
+    };
+
+    RandomStream();
+    RandomStream(const uint64_t seed, const uint64_t streamId);
+
+    static uint64_t makeStreamId(const StreamKind kind, const uint32_t index, const uint32_t serial = 0);
+
+    uint32_t nextUInt();
+    float nextFloat();
+    float nextFloat(const float minV, const float maxV);
+    int nextInt(const int minV, const int maxV);
+
+    void fill(float *out, const int n);
+    void fill(float *out, const int n, const float minV, const float maxV);
+
+    static void philox(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+private:
+    uint32_t key[2];
+    uint32_t counter[4];
+
+    uint32_t block[4];
+    int used;
+
+    void nextBlock();
+    static float toFloat(const uint32_t x);
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,88 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: ThreadPool.cpp
+
+
+#include "ThreadPool.h"
+using namespace std;
+
+ThreadPool::ThreadPool(int threadsNumber)
+{
+    if (threadsNumber <= 0) threadsNumber = thread::hardware_concurrency();
+    if (threadsNumber <= 0) threadsNumber = 1;
+
+    runningTasks = 0;
+    stopping = false;
+
+    for (int i = 0; i < threadsNumber; i++)
+    {
+        workers.push_back(thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        unique_lock<mutex> lock(tasksMutex);
+        stopping = true;
+    }
+    taskAdded.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::enqueue(const function<void()> &task)
+{
+    {
+        unique_lock<mutex> lock(tasksMutex);
+        tasks.push(task);
+    }
+    taskAdded.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    unique_lock<mutex> lock(tasksMutex);
+    tasksDone.wait(lock, [this] {return tasks.empty() && runningTasks == 0;});
+}
+
+int ThreadPool::getThreadsNumber() const
+{
+    return workers.size();
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        function<void()> task;
+
+        {
+            unique_lock<mutex> lock(tasksMutex);
+            taskAdded.wait(lock, [this] {return stopping || !tasks.empty();});
+
+            if (tasks.empty()) return;
+
+            task = tasks.front();
+            tasks.pop();
+            runningTasks++;
+        }
+
+        task();
+
+        {
+            unique_lock<mutex> lock(tasksMutex);
+            runningTasks--;
+            if (tasks.empty() && runningTasks == 0) tasksDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,50 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: ThreadPool.h
+
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class ThreadPool
+{
+public:
+    ThreadPool(int threadsNumber = 0);
+    ~ThreadPool();
+
+    void enqueue(const std::function<void()> &task);
+    void wait();
+
+    int getThreadsNumber() const;
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator = (const ThreadPool&);
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()> > tasks;
+
+    std::mutex tasksMutex;
+    std::condition_variable taskAdded;
+    std::condition_variable tasksDone;
+
+    int runningTasks;
+    bool stopping;
+
+    void workerLoop();
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,143 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: TimerWheel.cpp
+
+
+#include "TimerWheel.h"
+using namespace std;
+
+TimerWheel::TimerWheel(const double tickLength)
+{
+    resolution = tickLength;
+    current = 0;
+    count = 0;
+}
+
+uint64_t TimerWheel::tickOf(const double time) const
+{
+    if (time <= 0) return 0;
+    return (uint64_t)(time / resolution);
+}
+
+void TimerWheel::schedule(const double due, const int id)
+{
+    Event event;
+    event.due = due;
+    event.id = id;
+
+    insert(event);
+    count++;
+}
+
+//Event goes to the lowest level whose slots still cover its tick - the one where
+//its tick and the current one differ only in the bits of the slot
+void TimerWheel::insert(const Event &event)
+{
+    uint64_t tick = tickOf(event.due);
+    if (tick < current) tick = current;
+
+    for (int level = 0; level < LEVELS; level++)
+    {
+        const int shift = SLOT_BITS * (level + 1);
+
+        if ((tick >> shift) == (current >> shift))
+        {
+            wheels[level][(tick >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back(event);
+            return;
+        }
+    }
+
+    overflow.push_back(event);
+}
+
+//Entering a new slot of a higher level moves its events down, highest level first
+void TimerWheel::cascade()
+{
+    int top = 0;
+    while (top < LEVELS && (current & (((uint64_t)1 << (SLOT_BITS * (top + 1))) - 1)) == 0) top++;
+
+    vector<Event> moved;
+
+    if (top == LEVELS)
+    {
+        moved.swap(overflow);
+        for (const auto &event : moved) insert(event);
+        top = LEVELS - 1;
+    }
+
+    for (int level = top; level >= 1; level--)
+    {
+        moved.clear();
+        moved.swap(wheels[level][(current >> (SLOT_BITS * level)) & (SLOTS - 1)]);
+
+        for (const auto &event : moved) insert(event);
+    }
+}
+
+void TimerWheel::advance(const double now, vector<int> &fired)
+{
+    const uint64_t target = tickOf(now);
+
+    while (true)
+    {
+        vector<Event> &slot = wheels[0][current & (SLOTS - 1)];
+
+        if (current < target)
+        {
+            for (const auto &event : slot) fired.push_back(event.id);
+
+            count -= slot.size();
+            slot.clear();
+        }
+        else
+        {
+            //the tick of now is passed only partly
+            unsigned int kept = 0;
+
+            for (unsigned int i = 0; i < slot.size(); i++)
+            {
+                if (slot[i].due < now)
+                {
+                    fired.push_back(slot[i].id);
+                    count--;
+                }
+                else
+                {
+                    slot[kept++] = slot[i];
+                }
+            }
+
+            slot.resize(kept);
+            break;
+        }
+
+        current++;
+        cascade();
+    }
+}
+
+void TimerWheel::clear()
+{
+    for (int level = 0; level < LEVELS; level++)
+    {
+        for (int s = 0; s < SLOTS; s++)
+        {
+            wheels[level][s].clear();
+        }
+    }
+
+    overflow.clear();
+    current = 0;
+    count = 0;
+}
+
+int TimerWheel::size() const
+{
+    return count;
+}
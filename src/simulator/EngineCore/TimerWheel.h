@@ -0,0 +1,64 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: TimerWheel.h
+
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <vector>
+#include <cstdint>
+
+//Hierarchical timer wheel. Time is cut into ticks of the given length; level 0 has
+//a slot for each of the next SLOTS ticks, every higher level a slot for SLOTS slots
+//of the level below. Scheduling an event is constant time and advancing the time
+//visits only the passed slots of level 0 - an event far ahead is moved a level
+//down when its slot is reached, so idle timers cost nothing between their events.
+
+class TimerWheel
+{
+public:
+    TimerWheel(const double tickLength);
+
+    //id is returned by advance once the time has passed due
+    void schedule(const double due, const int id);
+
+    //appends ids of all events due before now, tick by tick, in the order of
+    //scheduling within a tick
+    void advance(const double now, std::vector<int> &fired);
+
+    void clear();
+    int size() const;
+
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+
+private:
+    struct Event
+    {
+        double due;
+        int id;
+    };
+
+    double resolution;
+    uint64_t current;
+    int count;
+
+    std::vector<Event> wheels[LEVELS][SLOTS];
+
+    //events beyond the last level
+    std::vector<Event> overflow;
+
+    uint64_t tickOf(const double time) const;
+    void insert(const Event &event);
+    void cascade();
+};
+
+#endif // TIMERWHEEL_H
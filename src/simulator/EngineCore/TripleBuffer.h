@@ -0,0 +1,72 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: TripleBuffer.h
+
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+//Lock-free hand-over of the latest value from one writer thread to one reader
+//thread. The writer fills its own buffer and publishes it by swapping it with the
+//middle one, the reader takes the middle one when something new was published -
+//neither of them ever waits and the reader always gets a complete value.
+
+template <class T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : middle(1)
+    {
+        writeIndex = 0;
+        readIndex = 2;
+    }
+
+    T& getWriteBuffer()
+    {
+        return buffers[writeIndex];
+    }
+
+    void publish()
+    {
+        writeIndex = middle.exchange(writeIndex | FRESH) & INDEX;
+    }
+
+    //takes the latest published value, returns false if there was none since the last call
+    bool update()
+    {
+        if ((middle.load() & FRESH) == 0) return false;
+
+        readIndex = middle.exchange(readIndex) & INDEX;
+        return true;
+    }
+
+    const T& getReadBuffer() const
+    {
+        return buffers[readIndex];
+    }
+
+private:
+    TripleBuffer(const TripleBuffer&);
+    TripleBuffer& operator = (const TripleBuffer&);
+
+    static const int INDEX = 3;
+    static const int FRESH = 4;
+
+    T buffers[3];
+
+    //index of the middle buffer with the FRESH bit set when it wasn't read yet
+    std::atomic<int> middle;
+
+    int writeIndex;
+    int readIndex;
+};
+
+#endif // TRIPLEBUFFER_H
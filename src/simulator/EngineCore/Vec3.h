@@ -13,39 +13,180 @@
 #define VEC3_H
 
 #include <cmath>
+#include <vector>
 #include <iostream>
 
+#include "Angle.h"
+
+//Header only - all operations are inlined into the hot paths, the ones without
+//square roots and trigonometry are also usable in constant expressions
+
 class Vec3
 {
 public:
 
-    Vec3();
-    Vec3(const float a, const float b, const float c);
+    Vec3() = default;
+    constexpr Vec3(const float a, const float b, const float c) : x(a), y(b), z(c) {}
 
     float x,y,z;
-    static float dst(const Vec3 b, const Vec3 e);
-    static float length(const Vec3 a);
-    static Vec3 lerp(Vec3 b, Vec3 e, float s);
-    static Vec3 cross(const Vec3 u, const Vec3 v);
-    static float angleDiff(float b, float e);
 
-    float angleXZ() const;
+    static float dst(const Vec3 b, const Vec3 e)
+    {
+        const float dx = e.x-b.x;
+        const float dy = e.y-b.y;
+        const float dz = e.z-b.z;
+
+        return std::sqrt(dx*dx + dy*dy + dz*dz);
+    }
+
+    static float length(const Vec3 a)
+    {
+        return std::sqrt(a.x*a.x + a.y*a.y + a.z*a.z);
+    }
+
+    static constexpr Vec3 lerp(const Vec3 b, const Vec3 e, const float s)
+    {
+        return Vec3(b.x + (e.x-b.x)*s, b.y + (e.y-b.y)*s, b.z + (e.z-b.z)*s);
+    }
+
+    static constexpr Vec3 cross(const Vec3 u, const Vec3 v)
+    {
+        return Vec3(u.y*v.z - u.z*v.y, u.z*v.x - u.x*v.z, u.x*v.y - u.y*v.x);
+    }
+
+    static float angleDiff(const float b, const float e)
+    {
+        return Angle::diff(b, e);
+    }
+
+    //heading of the vector in the XZ plane, in degrees
+    float angleXZ() const
+    {
+        return -(float)(std::atan2(z, x) * 57.2958);
+    }
+
+    void normalize()
+    {
+        const float dst = std::sqrt(x*x+y*y+z*z);
+        x /= dst;
+        y /= dst;
+        z /= dst;
+    }
 
-    void normalize();
+    Vec3& operator += (const Vec3& right)
+    {
+        x += right.x;
+        y += right.y;
+        z += right.z;
 
-    Vec3& operator += (const Vec3& right);
-    Vec3& operator -= (const Vec3& right);
-    Vec3& operator *= (const float right);
-    Vec3& operator /= (const float right);
+        return *this;
+    }
 
-    Vec3 operator - ();
+    Vec3& operator -= (const Vec3& right)
+    {
+        x -= right.x;
+        y -= right.y;
+        z -= right.z;
+
+        return *this;
+    }
+
+    Vec3& operator *= (const float right)
+    {
+        x *= right;
+        y *= right;
+        z *= right;
+
+        return *this;
+    }
+
+    Vec3& operator /= (const float right)
+    {
+        x /= right;
+        y /= right;
+        z /= right;
+
+        return *this;
+    }
+
+    constexpr Vec3 operator - () const
+    {
+        return Vec3(-x,-y,-z);
+    }
 };
 
-Vec3 operator + (Vec3 left, const Vec3& right);
-Vec3 operator - (Vec3 left, const Vec3& right);
-Vec3 operator * (Vec3 left, const float right);
-Vec3 operator / (Vec3 left, const float right);
+constexpr Vec3 operator + (const Vec3 left, const Vec3 right)
+{
+    return Vec3(left.x + right.x, left.y + right.y, left.z + right.z);
+}
 
-std::ostream& operator << (std::ostream& out, const Vec3& right);
+constexpr Vec3 operator - (const Vec3 left, const Vec3 right)
+{
+    return Vec3(left.x - right.x, left.y - right.y, left.z - right.z);
+}
+
+constexpr Vec3 operator * (const Vec3 left, const float right)
+{
+    return Vec3(left.x * right, left.y * right, left.z * right);
+}
+
+constexpr Vec3 operator / (const Vec3 left, const float right)
+{
+    return Vec3(left.x / right, left.y / right, left.z / right);
+}
+
+inline std::ostream& operator << (std::ostream& out, const Vec3& right)
+{
+    out << "(" << right.x << ", " << right.y << ", " << right.z << ")";
+    return out;
+}
+
+//Many vectors as separate arrays of coordinates - the batch operations are plain
+//loops over contiguous floats, which the compiler turns into packed SIMD
+
+struct Vec3Array
+{
+    std::vector<float> x, y, z;
+
+    void resize(const int size)
+    {
+        x.resize(size);
+        y.resize(size);
+        z.resize(size);
+    }
+
+    int size() const
+    {
+        return x.size();
+    }
+
+    void set(const int i, const Vec3 v)
+    {
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+
+    Vec3 get(const int i) const
+    {
+        return Vec3(x[i], y[i], z[i]);
+    }
+
+    //out[i] = lerp(b[i], e[i], s[i]) for the first n vectors; out may be b or e
+    static void lerp(const Vec3Array &b, const Vec3Array &e, const float *s, Vec3Array &out, const int n)
+    {
+        lerp(&b.x[0], &e.x[0], s, &out.x[0], n);
+        lerp(&b.y[0], &e.y[0], s, &out.y[0], n);
+        lerp(&b.z[0], &e.z[0], s, &out.z[0], n);
+    }
+
+    static void lerp(const float *b, const float *e, const float *s, float *out, const int n)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            out[i] = b[i] + (e[i] - b[i]) * s[i];
+        }
+    }
+};
 
-#endif // VEC3_h
+#endif // VEC3_H
@@ -0,0 +1,149 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: WorkStealingPool.cpp
+
+
+#include "WorkStealingPool.h"
+using namespace std;
+
+WorkStealingPool::WorkStealingPool(int threadsNumber)
+{
+    if (threadsNumber <= 0) threadsNumber = thread::hardware_concurrency();
+    if (threadsNumber <= 0) threadsNumber = 1;
+
+    threads = threadsNumber;
+    ranges = new Range[threads];
+
+    for (int i = 0; i < threads; i++)
+    {
+        ranges[i].next = 0;
+        ranges[i].end = 0;
+    }
+
+    curTask = nullptr;
+    phase = 0;
+    busyWorkers = 0;
+    stopping = false;
+
+    //thread 0 is the one calling run
+    for (int i = 1; i < threads; i++)
+    {
+        workers.push_back(thread(&WorkStealingPool::workerLoop, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        unique_lock<mutex> lock(phaseMutex);
+        stopping = true;
+    }
+    phaseStarted.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    delete[] ranges;
+}
+
+int WorkStealingPool::getThreadsNumber() const
+{
+    return threads;
+}
+
+void WorkStealingPool::run(const int tasksNumber, const function<void(int)> &task)
+{
+    if (threads == 1 || tasksNumber <= 1)
+    {
+        for (int i = 0; i < tasksNumber; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    for (int i = 0; i < threads; i++)
+    {
+        ranges[i].next = (long long)tasksNumber * i / threads;
+        ranges[i].end = (long long)tasksNumber * (i + 1) / threads;
+    }
+
+    {
+        unique_lock<mutex> lock(phaseMutex);
+        curTask = &task;
+        busyWorkers = threads - 1;
+        phase++;
+    }
+    phaseStarted.notify_all();
+
+    work(0);
+
+    unique_lock<mutex> lock(phaseMutex);
+    phaseDone.wait(lock, [this] {return busyWorkers == 0;});
+    curTask = nullptr;
+
+    if (failure)
+    {
+        exception_ptr thrown = failure;
+        failure = nullptr;
+        rethrow_exception(thrown);
+    }
+}
+
+void WorkStealingPool::workerLoop(const int which)
+{
+    unsigned int donePhase = 0;
+
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(phaseMutex);
+            phaseStarted.wait(lock, [this, donePhase] {return stopping || phase != donePhase;});
+
+            if (stopping) return;
+            donePhase = phase;
+        }
+
+        work(which);
+
+        {
+            unique_lock<mutex> lock(phaseMutex);
+            busyWorkers--;
+            if (busyWorkers == 0) phaseDone.notify_all();
+        }
+    }
+}
+
+//Own range first, then the ranges of the next threads in turn. An exception must not
+//leave a worker thread; the thread stops taking tasks and run rethrows it
+void WorkStealingPool::work(const int which)
+{
+    const function<void(int)> &task = *curTask;
+
+    try
+    {
+        for (int k = 0; k < threads; k++)
+        {
+            Range &range = ranges[(which + k) % threads];
+
+            int i;
+            while ((i = range.next.fetch_add(1)) < range.end)
+            {
+                task(i);
+            }
+        }
+    }
+    catch (...)
+    {
+        unique_lock<mutex> lock(phaseMutex);
+        if (!failure) failure = current_exception();
+    }
+}
@@ -0,0 +1,74 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: WorkStealingPool.h
+
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+//Threads running many short tasks of one phase and returning at its end. Every
+//thread starts with its own contiguous range of task indexes and, when done with
+//it, steals the remaining tasks of the others - tasks are taken by an atomic
+//increment of a range counter, no lock is held while working. The calling thread
+//takes part in the work.
+
+class WorkStealingPool
+{
+public:
+    WorkStealingPool(int threadsNumber = 0);
+    ~WorkStealingPool();
+
+    //calls task(i) for every i from 0 to tasksNumber - 1, returns when all are done;
+    //the first exception thrown by a task is rethrown then
+    void run(const int tasksNumber, const std::function<void(int)> &task);
+
+    int getThreadsNumber() const;
+
+private:
+    WorkStealingPool(const WorkStealingPool&);
+    WorkStealingPool& operator = (const WorkStealingPool&);
+
+    //one cache line per range, so threads taking tasks don't slow down each other
+    struct Range
+    {
+        std::atomic<int> next;
+        int end;
+        char padding[56];
+    };
+
+    int threads;
+    Range *ranges;
+    std::vector<std::thread> workers;
+
+    const std::function<void(int)> *curTask;
+
+    std::mutex phaseMutex;
+    std::condition_variable phaseStarted;
+    std::condition_variable phaseDone;
+
+    unsigned int phase;
+    int busyWorkers;
+    bool stopping;
+
+    //first exception of the phase, guarded by phaseMutex
+    std::exception_ptr failure;
+
+    void workerLoop(const int which);
+    void work(const int which);
+};
+
+#endif // WORKSTEALINGPOOL_H
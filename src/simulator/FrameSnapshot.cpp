@@ -0,0 +1,195 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: FrameSnapshot.cpp
+
+
+#include "FrameSnapshot.h"
+#include "VehicleStore.h"
+using namespace std;
+
+const Vec3 FrameRenderer::blinkerColor = Vec3(1, 0.647, 0);
+
+FrameSnapshot::FrameSnapshot()
+{
+    time = 0;
+}
+
+void FrameRenderer::drawVehicles(const FrameSnapshot &frame)
+{
+    for (const auto &vehicle : frame.vehicles)
+    {
+        pushMatrix();
+
+        translate(vehicle.position);
+        rotateY(vehicle.heading);
+
+        if (vehicle.kind == VehicleStore::BUS)
+            drawBus(vehicle);
+        else
+            drawCar(vehicle);
+
+        popMatrix();
+    }
+}
+
+void FrameRenderer::drawCar(const VehicleSnapshot &vehicle)
+{
+    const int blinkerWhich = vehicle.blinker;
+    const Vec3 &color = vehicle.color;
+
+    translate(0, -0.02, 0);
+
+    if (blinkerWhich < 0)
+    {
+        pushMatrix();
+        translate(0,0.05,-0.038);
+        setColor(blinkerColor);
+        drawCube(0.22,0.02,0.01);
+        popMatrix();
+    }
+    if (blinkerWhich > 0)
+    {
+        pushMatrix();
+        translate(0,0.05,0.038);
+        setColor(blinkerColor);
+        drawCube(0.22,0.02,0.01);
+        popMatrix();
+    }
+
+    if (vehicle.braking)
+    {
+        setColor(1,0,0);
+
+        pushMatrix();
+        translate(-0.05,0.08,0);
+        drawCube(0.07,0.003,0.04);
+        popMatrix();
+
+        pushMatrix();
+        translate(-0.05,0.05,0.033);
+        drawCube(0.12,0.01,0.01);
+        popMatrix();
+
+        pushMatrix();
+        translate(-0.05,0.05,-0.033);
+        drawCube(0.12,0.01,0.01);
+        popMatrix();
+    }
+    setColor(color);
+
+    pushMatrix();
+    translate(0,0.05,0);
+    drawCube(0.2,0.05,0.1);
+    drawRoof();
+
+    popMatrix();
+}
+
+void FrameRenderer::drawRoof()
+{
+    Vec3 a1(0,0,-0.05);
+    Vec3 a2(0.025,0.05,-0.0375);
+    Vec3 a3(0.075,0.05,-0.0375);
+    Vec3 a4(0.1125,0,-0.05);
+    Vec3 a5(0,0,0.05);
+    Vec3 a6(0.025,0.05,0.0375);
+    Vec3 a7(0.075,0.05,0.0375);
+    Vec3 a8(0.1125,0,0.05);
+
+    pushMatrix();
+    translate(-0.075, 0.025, 0);
+    beginDraw(QUADS);
+
+    drawQuad(a2,a6,a7,a3);
+
+    setColor(0,1,1);
+
+    drawQuad(a1,a2,a3,a4);
+    drawQuad(a1,a5,a6,a2);
+    drawQuad(a5,a8,a7,a6);
+    drawQuad(a8,a4,a3,a7);
+
+    endDraw();
+    popMatrix();
+}
+
+void FrameRenderer::drawBus(const VehicleSnapshot &vehicle)
+{
+    const int blinkerWhich = vehicle.blinker;
+    const Vec3 &color = vehicle.color;
+    const float busAngle = vehicle.busAngle;
+
+    pushMatrix();
+
+    translate(0,0.07,0);
+
+    setColor(color);
+    pushMatrix();
+    rotateY(-busAngle / 1.3);
+    translate(-0.2,0,0);
+    drawCube(0.3,0.13,0.135);
+    setColor(0,0.8,0.8);
+    translate(-0.02,0.02,0);
+    drawCube(0.25,0.07,0.14);
+    popMatrix();
+
+    setColor(color);
+    pushMatrix();
+
+    rotateY(busAngle / 4);
+    translate(0.2,0,0);
+    drawCube(0.3, 0.13, 0.135);
+    setColor(0,0.8,0.8);
+    translate(0.02,0.02,0);
+    drawCube(0.27,0.07,0.14);
+    popMatrix();
+
+    setColor(0.5,0.5,0);
+    drawCube(0.2,0.12,0.12);
+
+    pushMatrix();
+    if (blinkerWhich < 0)
+    {
+        setColor(blinkerColor);
+        translate(0, -0.031,-0.046);
+        drawCube(0.73,0.01,0.01);
+    }
+    if (blinkerWhich > 0)
+    {
+        setColor(blinkerColor);
+        translate(0, -0.031,0.046);
+        drawCube(0.73,0.01,0.01);
+    }
+    popMatrix();
+
+    if (vehicle.braking)
+    {
+        pushMatrix();
+        setColor(1,0,0);
+        rotateY(-busAngle / 1.3);
+
+        pushMatrix();
+        translate(-0.3,0.05,0);
+        drawCube(0.12,0.003,0.06);
+        popMatrix();
+
+        pushMatrix();
+        translate(-0.3,-0.02,0.04);
+        drawCube(0.12,0.01,0.01);
+        popMatrix();
+
+        pushMatrix();
+        translate(-0.3,-0.02,-0.04);
+        drawCube(0.12,0.01,0.01);
+        popMatrix();
+        popMatrix();
+    }
+
+    popMatrix();
+}
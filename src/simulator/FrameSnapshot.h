@@ -0,0 +1,68 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: FrameSnapshot.h
+
+
+#ifndef FRAMESNAPSHOT_H
+#define FRAMESNAPSHOT_H
+
+#include <vector>
+
+#include "EngineCore/Graphics.h"
+
+class CrossLights;
+
+//Everything that changes on the screen between frames, copied out of the simulation
+//at the end of its frame; the window thread draws it while the simulation goes on
+
+struct VehicleSnapshot
+{
+    Vec3 position;
+    float heading;
+    float busAngle;
+    Vec3 color;
+
+    unsigned char kind;
+
+    //side of the blinker which is lit at the moment, 0 when none
+    signed char blinker;
+    bool braking;
+};
+
+struct LightsSnapshot
+{
+    CrossLights *lights;
+    int state;
+};
+
+struct FrameSnapshot
+{
+    double time;
+    std::vector<VehicleSnapshot> vehicles;
+    std::vector<LightsSnapshot> lights;
+
+    FrameSnapshot();
+};
+
+//Draws vehicles of a snapshot, without touching the simulation
+
+class FrameRenderer : private Graphics
+{
+public:
+    void drawVehicles(const FrameSnapshot &frame);
+
+private:
+    static const Vec3 blinkerColor;
+
+    void drawCar(const VehicleSnapshot &vehicle);
+    void drawRoof();
+    void drawBus(const VehicleSnapshot &vehicle);
+};
+
+#endif // FRAMESNAPSHOT_H
@@ -10,23 +10,26 @@
 
 
 #include "GameObject.h"
+#include "Simulation.h"
 
-GameObject::GameObject()
+GameObject::GameObject(Simulation *sim)
 {
+    simulation = sim;
+    id = SymbolTable::NONE;
+    objectIndex = -1;
+
     pos = Vec3(0,0,0);
     rot = Vec3(0,0,0);
 }
 
 float GameObject::randFloat(const float minV, const float maxV)
 {
-    float d = maxV - minV;
-    return minV + d*(rand()%1000)/1000.0;
+    return random.nextFloat(minV, maxV);
 }
 
 int GameObject::randInt(const int minV, const int maxV)
 {
-    int d = maxV - minV + 1;
-    return minV + rand()%d;
+    return random.nextInt(minV, maxV);
 }
 
 void GameObject::setPos(const Vec3 p)
@@ -49,6 +52,11 @@ Vec3 GameObject::getRot() const
     return rot;
 }
 
+std::string GameObject::getName() const
+{
+    return simulation->getSymbols().getName(id);
+}
+
 void GameObject::drawObject()
 {
     pushMatrix();
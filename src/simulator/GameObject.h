@@ -16,6 +16,9 @@
 #include <cstdlib>
 #include <queue>
 #include "EngineCore/Graphics.h"
+#include "EngineCore/Random.h"
+
+class Simulation;
 
 class GameObject : public Graphics
 {
@@ -24,9 +27,12 @@ public:
     void setRot(const Vec3 r);
     Vec3 getPos() const;
     Vec3 getRot() const;
-    std::string id;
 
-    GameObject();
+    //dense ID of an interned name (see SymbolTable), NONE for spawned objects
+    int id;
+    virtual std::string getName() const;
+
+    GameObject(Simulation *sim);
     virtual ~GameObject(){};
 
     void updateObject(const float delta);
@@ -36,9 +42,18 @@ protected:
     Vec3 pos;
     Vec3 rot;
 
+    Simulation *simulation;
+    RandomStream random;
+
     virtual void update(const float delta);
-    static float randFloat(const float minV, const float maxV);
-    static int randInt(const int minV, const int maxV);
+    float randFloat(const float minV, const float maxV);
+    int randInt(const int minV, const int maxV);
+
+private:
+    //position in the simulation's list of objects, kept up to date on removal
+    int objectIndex;
+
+    friend Simulation;
 };
 
 #endif // GAMEOBJECT_H
@@ -10,20 +10,20 @@
 
 
 #include "Garage.h"
+#include "Simulation.h"
 using namespace std;
 
-int Garage::vehiclesCounter = 0;
-
-Garage::Garage(Vec3 p, Cross *c) : Driveable(p, c)
+Garage::Garage(Simulation *sim, Vec3 p, Cross *c) : Driveable(sim, p, c)
 {
-    curTimeSpot = 0;
-    frecSpot = 4;
+    garageIndex = sim->nextStreamIndex(RandomStream::GARAGE);
+    random = sim->createStream(RandomStream::GARAGE, garageIndex);
+    spawnedNumber = 0;
 
-    curTimeDelete = 0;
+    frecSpot = 4;
     frecDelete = 6;
 
-    isReadyToSpot = false;
-    isReadyToDelete = false;
+    spotState = WAITING;
+    deleteState = WAITING;
 
     spottedVehicles = 0;
     maxVehicles = 30;
@@ -42,109 +42,81 @@ void Garage::draw()
     Driveable::draw();
 }
 
-void Garage::update(const float delta)
+//the last spawned vehicle has driven away from the garage
+bool Garage::isExitClear() const
 {
-    if (vehiclesBeg.size() == 0 || (vehiclesBeg.size() > 0 && vehiclesBeg.back()->xPos > 1))
-        curTimeSpot += delta;
-
-    if (curTimeSpot > frecSpot && spottedVehicles < maxVehicles)
-    {
-        isReadyToSpot = true;
-    }
-
-    if (vehiclesEnd.size() > 0)
-        curTimeDelete += delta;
-
-    if (curTimeDelete > frecDelete)
-    {
-        if (vehiclesEnd.size() > 0)
-        {
-            isReadyToDelete = true;
-        }
-    }
+    const SlotRing &laneOut = getLane(true);
+    return laneOut.empty() || simulation->getVehicleStore().xPos[laneOut.back()] > 1;
 }
 
-string Garage::itos(const int x)
+bool Garage::hasVehiclesInside() const
 {
-    ostringstream ss;
-    ss << x;
-    return ss.str();
+    return !getLane(false).empty();
 }
 
 Vehicle* Garage::spotVeh()
 {
-    curTimeSpot = 0;
-    isReadyToSpot = false;
+    spotState = WAITING;
 
-    Vehicle *temp = createVehicle();
+    Vehicle *temp = createVehicle(spawnedNumber);
+
+    temp->origin = id;
+    temp->number = spawnedNumber++;
 
     temp->curRoad = this;
     temp->direction = true;
-    temp->isFirstVeh = vehiclesBeg.size() == 0;
 
-    vehiclesBeg.push(temp);
+    simulation->getVehicleStore().enterLane(getLaneIndex(true), temp->slot);
 
     spottedVehicles++;
-    vehiclesCounter++;
 
     return temp;
 }
 
-Vehicle* Garage::deleteVeh()
+void Garage::deleteVeh()
 {
-    curTimeDelete = 0;
-    isReadyToDelete = false;
+    deleteState = WAITING;
+
+    VehicleStore &store = simulation->getVehicleStore();
+    const SlotRing &laneIn = getLane(false);
 
-    if (vehiclesEnd.size() > 0)
+    if (!laneIn.empty())
     {
-        Vehicle *temp = vehiclesEnd.front();
-        vehiclesEnd.pop();
+        Vehicle *temp = store.owner[laneIn.front()];
+        store.leaveLane(getLaneIndex(false));
 
-        if(temp->backVeh != nullptr)
-        {
-            temp->backVeh->isFirstVeh = true;
-            temp->backVeh->frontVeh = nullptr;
-        }
-        delete temp;
+        simulation->getVehiclePool().destroy(temp);
 
         spottedVehicles--;
-
-        return temp;
     }
-
-    return nullptr;
 }
 
 bool Garage::checkReadyToSpot() const
 {
-    return isReadyToSpot;
+    return spotState == READY;
 }
 
 bool Garage::checkReadyToDelete() const
 {
-    return isReadyToDelete;
+    return deleteState == READY;
 }
 
-GarageCar::GarageCar(Vec3 p, Cross *c) : Garage(p, c)
+GarageCar::GarageCar(Simulation *sim, Vec3 p, Cross *c) : Garage(sim, p, c)
 {
 
 }
 
-Vehicle *GarageCar::createVehicle()
+Vehicle *GarageCar::createVehicle(const int number)
 {
-    Vehicle *temp = new Car(this);
-    temp->id = "CAR_" + id + "_" + itos(Garage::vehiclesCounter);
-    return temp;
+    return simulation->getVehiclePool().create<Car>(simulation, this, simulation->createStream(RandomStream::VEHICLE, garageIndex, number));
 }
 
-GarageBus::GarageBus(Vec3 p, Cross *c) : Garage(p, c)
+GarageBus::GarageBus(Simulation *sim, Vec3 p, Cross *c) : Garage(sim, p, c)
 {
 
 }
 
-Vehicle *GarageBus::createVehicle()
+Vehicle *GarageBus::createVehicle(const int number)
 {
-    Vehicle *temp = new Bus(this);
-    temp->id = "BUS_" + id + "_" + itos(Garage::vehiclesCounter);
-    return temp;
+    return simulation->getVehiclePool().create<Bus>(simulation, this, simulation->createStream(RandomStream::VEHICLE, garageIndex, number));
 }
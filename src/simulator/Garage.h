@@ -15,59 +15,70 @@
 #include "Road.h"
 #include "Vehicle.h"
 
+//Spawning and despawning are timed by the timers of the simulation - the time to
+//spawn runs from the moment the exit is clear, the time to despawn from the arrival
+//of a vehicle into the empty garage or from the last despawn
+
 class Garage : public Driveable
 {
 public:
+    enum TimerState
+    {
+        WAITING,    //for a clear exit, or for a vehicle to despawn
+        COUNTING,   //timer event scheduled
+        FULL,       //time to spawn is up, but the garage has the most vehicles out
+        READY       //at the beginning of the next tick
+    };
+
     bool checkReadyToSpot() const;
     bool checkReadyToDelete() const;
 
 private:
     float frecSpot;
-    float curTimeSpot;
-
     float frecDelete;
-    float curTimeDelete;
+
+    TimerState spotState;
+    TimerState deleteState;
 
     void draw();
-    void update(const float delta);
 
-    Vehicle* spotVeh();
-    Vehicle* deleteVeh();
+    bool isExitClear() const;
+    bool hasVehiclesInside() const;
 
-    bool isReadyToSpot;
-    bool isReadyToDelete;
+    Vehicle* spotVeh();
+    void deleteVeh();
 
     int spottedVehicles;
     int maxVehicles;
 
-    friend Simulator;
+    friend Simulation;
     friend ObjectsLoader;
 
 protected:
-    Garage(Vec3 p, Cross *c);
+    Garage(Simulation *sim, Vec3 p, Cross *c);
 
-    std::string itos(const int x);
-    virtual Vehicle *createVehicle() = 0;
+    virtual Vehicle *createVehicle(const int number) = 0;
 
-    static int vehiclesCounter;
+    uint32_t garageIndex;
+    uint32_t spawnedNumber;
 };
 
 class GarageCar : public Garage
 {
 public:
-    GarageCar(Vec3 p, Cross *c);
+    GarageCar(Simulation *sim, Vec3 p, Cross *c);
 
 protected:
-    Vehicle *createVehicle();
+    Vehicle *createVehicle(const int number);
 };
 
 class GarageBus : public Garage
 {
 public:
-    GarageBus(Vec3 p, Cross *c);
+    GarageBus(Simulation *sim, Vec3 p, Cross *c);
 
 protected:
-    Vehicle *createVehicle();
+    Vehicle *createVehicle(const int number);
 };
 
 #endif // GARAGE_H
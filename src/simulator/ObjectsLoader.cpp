@@ -12,16 +12,24 @@
 #include "ObjectsLoader.h"
 using namespace std;
 
+ObjectsLoader::ObjectsLoader()
+{
+    verbose = true;
+}
+
+void ObjectsLoader::setVerbose(const bool v)
+{
+    verbose = v;
+}
+
 void ObjectsLoader::loadRoad(const string fileName)
 {
-    cout << "Loading objects from " << fileName << "...  ";
+    if (verbose) cout << "Loading objects from " << fileName << "...  ";
 
     ifstream file;
     file.open(fileName.c_str());
     if (file.good())
     {
-        vector<Cross*>crosses;
-
         while (!file.eof())
         {
             try
@@ -55,11 +63,10 @@ void ObjectsLoader::loadRoad(const string fileName)
                     Vec3 v1(x1,y1,z1);
 
                     Cross *temp;
-                    temp = new Cross(v1);
-                    temp->id = id;
+                    temp = new Cross(getSimulation(), v1);
+                    temp->id = getSymbols().intern(id);
 
                     loadedNewObject(temp);
-                    crosses.push_back(temp);
                 }
                 else if (type.compare("ST") == 0 || type.compare("STREET") == 0)
                 {
@@ -67,32 +74,15 @@ void ObjectsLoader::loadRoad(const string fileName)
                     string endCrossID;
                     ss >> begCrossID >> endCrossID;
                     if (ss.fail()) throw ExceptionClass("failed to load info about street " + id);
-                    Cross *crossB = nullptr;
-                    Cross *crossE = nullptr;
-
-                    for (unsigned int i=0;i<crosses.size();i++)
-                    {
-                        if (crosses[i]->id.compare(begCrossID) == 0)
-                        {
-                            crossB = crosses[i];
-                            break;
-                        }
-                    }
+                    Cross *crossB = dynamic_cast<Cross*>(findObjectByName(begCrossID));
                     if (crossB == nullptr) throw ExceptionClass("could not find intersection " + begCrossID + " for street " + id);
 
-                    for (unsigned int i=0;i<crosses.size();i++)
-                    {
-                        if (crosses[i]->id.compare(endCrossID) == 0)
-                        {
-                            crossE = crosses[i];
-                            break;
-                        }
-                    }
+                    Cross *crossE = dynamic_cast<Cross*>(findObjectByName(endCrossID));
                     if (crossE == nullptr) throw ExceptionClass("could not find intersection " + begCrossID + " for street " + id);
 
                     GameObject *temp;
-                    temp = new Street(crossB, crossE);
-                    temp->id = id;
+                    temp = new Street(getSimulation(), crossB, crossE);
+                    temp->id = getSymbols().intern(id);
 
                     loadedNewObject(temp);
                 }
@@ -109,25 +99,17 @@ void ObjectsLoader::loadRoad(const string fileName)
                     transform(vehType.begin(), vehType.end(), vehType.begin(), [] (unsigned char c) -> unsigned char {return toupper(c);});
 
                     Vec3 v(x,y,z);
-                    Cross *cross = nullptr;
-                    for(unsigned int i=0;i<crosses.size();i++)
-                    {
-                        if (crosses[i]->id.compare(jointCross) == 0)
-                        {
-                            cross = crosses[i];
-                            break;
-                        }
-                    }
+                    Cross *cross = dynamic_cast<Cross*>(findObjectByName(jointCross));
                     if (cross == nullptr) throw ExceptionClass("could not find intersection " + jointCross + " for garage " + id);
 
                     Garage *temp = nullptr;
 
-                         if (vehType.compare("C") == 0 || vehType.compare("CAR") == 0) temp = new GarageCar(v, cross);
-                    else if (vehType.compare("B") == 0 || vehType.compare("BUS") == 0) temp = new GarageBus(v, cross);
+                         if (vehType.compare("C") == 0 || vehType.compare("CAR") == 0) temp = new GarageCar(getSimulation(), v, cross);
+                    else if (vehType.compare("B") == 0 || vehType.compare("BUS") == 0) temp = new GarageBus(getSimulation(), v, cross);
 
                     if (temp == nullptr) throw ExceptionClass("failed to create garage " + id + " of vehicle type " + vehType);
 
-                    temp->id = id;
+                    temp->id = getSymbols().intern(id);
                     temp->maxVehicles = maxVehicles;
                     temp->frecSpot = spotFrec;
 
@@ -142,11 +124,10 @@ void ObjectsLoader::loadRoad(const string fileName)
                     Vec3 v1(x1,y1,z1);
 
                     Cross *temp;
-                    temp = new CrossLights(v1);
-                    temp->id = id;
+                    temp = new CrossLights(getSimulation(), v1);
+                    temp->id = getSymbols().intern(id);
 
                     loadedNewObject(temp);
-                    crosses.push_back(temp);
                 }
                 else
                 {
@@ -169,12 +150,12 @@ void ObjectsLoader::loadRoad(const string fileName)
     }
     file.close();
 
-    cout << "Success" << endl;
+    if (verbose) cout << "Success" << endl;
 }
 
 void ObjectsLoader::loadRightOfWay(const string fileName)
 {
-    cout << "Loading right of way from " << fileName << "...  ";
+    if (verbose) cout << "Loading right of way from " << fileName << "...  ";
 
     ifstream file;
     file.open(fileName.c_str());
@@ -196,9 +177,9 @@ void ObjectsLoader::loadRightOfWay(const string fileName)
                 if (ss.fail()) throw EmptyLineException();
 
                 ss >> number;
-                if (ss.fail() || number > 4 || number < 2) throw ExceptionClass("failed to read number of streets at intersection " + id);
+                if (ss.fail() || number > Cross::MAX_STREETS || number < 2) throw ExceptionClass("failed to read number of streets at intersection " + id);
 
-                Driveable *ptrs[4];
+                vector<Driveable*> ptrs(number);
 
                 for(int i=0;i<number;i++)
                 {
@@ -214,7 +195,7 @@ void ObjectsLoader::loadRightOfWay(const string fileName)
                 if (cross != nullptr)
                 {
                     if (number != (int)cross->streets.size()) throw ExceptionClass("incorrect number of streets at intersection " + id);
-                    cross->setDefaultPriority(ptrs[0], ptrs[1], ptrs[2], ptrs[3]);
+                    cross->setDefaultPriority(ptrs);
                 }
                 else
                 {
@@ -237,5 +218,5 @@ void ObjectsLoader::loadRightOfWay(const string fileName)
     }
     file.close();
 
-    cout << "Success" << endl;
+    if (verbose) cout << "Success" << endl;
 }
@@ -21,19 +21,30 @@
 #include "Road.h"
 #include "Garage.h"
 #include "Vehicle.h"
+#include "SymbolTable.h"
+
+class Simulation;
 
 class ObjectsLoader
 {
 public:
+    ObjectsLoader();
+    virtual ~ObjectsLoader(){};
+
     void loadRoad(const std::string fileName);
     void loadRightOfWay(const std::string fileName);
+    void setVerbose(const bool v);
 
 protected:
     virtual GameObject* findObjectByName(const std::string on) const = 0;
     virtual void loadedNewObject(GameObject *newGameObject) = 0;
     virtual void loadedNewFactory(Garage *newIntersection) = 0;
+    virtual Simulation* getSimulation() = 0;
+    virtual SymbolTable& getSymbols() = 0;
 
 private:
+    bool verbose;
+
     enum EmptyLineException{};
 };
 
@@ -10,18 +10,35 @@
 
 
 #include "Road.h"
+#include "Simulation.h"
 using namespace std;
 
-class Simulator;
+class Simulation;
 
-Vec3 Road::roadColor = Vec3(0.3, 0.3, 0.3);
+const Vec3 Road::roadColor = Vec3(0.3, 0.3, 0.3);
+
+Road::Road(Simulation *sim) : GameObject(sim)
+{
+
+}
 
 float Driveable::getLength() const
 {
     return length;
 }
 
-Driveable::Driveable(Cross *begCross, Cross *endCross)
+int Driveable::getLaneIndex(const bool dir) const
+{
+    if (dir) return roadIndex * 2;
+    return roadIndex * 2 + 1;
+}
+
+const SlotRing& Driveable::getLane(const bool dir) const
+{
+    return simulation->getVehicleStore().getLane(getLaneIndex(dir));
+}
+
+Driveable::Driveable(Simulation *sim, Cross *begCross, Cross *endCross) : Road(sim)
 {
     crossBeg = begCross;
     crossEnd = endCross;
@@ -41,9 +58,11 @@ Driveable::Driveable(Cross *begCross, Cross *endCross)
     temp.direction = false;
     endJoint = crossEnd->getPos() - direction * 0.3;
     crossEnd->streets.push_back(temp);
+
+    cacheLaneGeometry();
 }
 
-Driveable::Driveable(Vec3 p, Cross *endCross)
+Driveable::Driveable(Simulation *sim, Vec3 p, Cross *endCross) : Road(sim)
 {
     crossBeg = nullptr;
     crossEnd = endCross;
@@ -61,6 +80,8 @@ Driveable::Driveable(Vec3 p, Cross *endCross)
     begJoint = begPos;
     endJoint = crossEnd->getPos() - direction * 0.3;
     crossEnd->streets.push_back(temp);
+
+    cacheLaneGeometry();
 }
 
 void Driveable::commonConstructor()
@@ -73,22 +94,12 @@ void Driveable::commonConstructor()
     normal = Vec3::cross(Vec3(0,1,0), direction);
     normal.normalize();
 
-    reservedSpaceBeg = 0;
-    reservedSpaceEnd = 0;
+    roadIndex = simulation->getVehicleStore().addRoad(length);
 }
 
 float Driveable::freeSpace(const bool dir) const
 {
-    if (dir)
-    {
-        if (vehiclesBeg.size() == 0) return getLength() - reservedSpaceBeg - 0.2;
-
-        return vehiclesBeg.back()->getXPos() - reservedSpaceBeg - 0.2;
-    }
-
-    if (vehiclesEnd.size() == 0) return getLength() - reservedSpaceEnd - 0.2;
-
-    return vehiclesEnd.back()->getXPos() - reservedSpaceEnd - 0.2;
+    return simulation->getVehicleStore().getFreeSpace(getLaneIndex(dir)) - 0.2;
 }
 
 Vec3 Driveable::getJointPoint(const bool dir) const
@@ -107,24 +118,28 @@ Vec3 Driveable::getDirection() const
     return direction;
 }
 
-Vec3 Driveable::getBegJointWidth(const bool dir) const
+//Lanes run on both sides of the road axis, 0.1 apart from it
+void Driveable::cacheLaneGeometry()
 {
-    if (dir)
+    for (int l = 0; l < 2; l++)
     {
-        return begJoint + normal * 0.1;
-    }
+        const bool dir = l == 0;
+        LaneGeometry &lane = laneGeometry[l];
 
-    return begJoint - normal * 0.1;
-}
+        Vec3 side = dir ? normal * 0.1 : normal * -0.1;
 
-Vec3 Driveable::getEndJointWidth(const bool dir) const
-{
-    if (dir)
-    {
-        return endJoint + normal * 0.1;
+        lane.entry = (dir ? begJoint : endJoint) + side;
+        lane.exit = (dir ? endJoint : begJoint) + side;
+        lane.direction = dir ? direction : direction * -1;
+        lane.heading = lane.direction.angleXZ();
+
+        simulation->getVehicleStore().setLaneGeometry(getLaneIndex(dir), lane.entry, lane.exit, lane.heading);
     }
+}
 
-    return endJoint - normal * 0.1;
+const Driveable::LaneGeometry& Driveable::getLaneGeometry(const bool dir) const
+{
+    return laneGeometry[dir ? 0 : 1];
 }
 
 void Driveable::draw()
@@ -149,12 +164,16 @@ void Driveable::draw()
     endDraw();
 }
 
-Cross::Cross(Vec3 position)
+Cross::Cross(Simulation *sim, Vec3 position) : Road(sim)
 {
+    random = sim->createStream(RandomStream::CROSS, sim->nextStreamIndex(RandomStream::CROSS));
+
     pos = position;
     allowedVeh = 0;
 
     isSet = false;
+    isActive = false;
+    region = 0;
 }
 
 void Cross::update(const float delta)
@@ -171,24 +190,12 @@ bool Cross::checkSet()
 {
     if (isSet) return false;
 
-    if(streets.size() == 4)
+    if (streets.size() < 2 || streets.size() > MAX_STREETS)
     {
-        setDefaultPriority(streets[0].street, streets[1].street, streets[2].street, streets[3].street);
+        throw ExceptionClass("failed to set default right of way at intersection " + getName());
     }
 
-    else if (streets.size() == 2)
-    {
-        setDefaultPriority();
-    }
-
-    else if (streets.size() == 3)
-    {
-        setDefaultPriority(streets[0].street, streets[1].street, streets[2].street);
-    }
-    else
-    {
-        throw ExceptionClass("failed to set default right of way at intersection " + id);
-    }
+    setDefaultPriority();
 
     return !isSet;
 }
@@ -208,72 +215,125 @@ void Cross::updateCross(const float delta)
     }
 }
 
+//Queues a vehicle approaching from the given street; an intersection with waiting
+//vehicles is updated by the simulation until all of them are let through
+
+void Cross::addWaitingVehicle(const int street, Vehicle *vehicle)
+{
+    streets[street].queue.push(vehicle->slot);
+
+    if (!isActive)
+    {
+        isActive = true;
+        simulation->activateCross(this);
+    }
+}
+
+bool Cross::hasWaitingVehicles() const
+{
+    for (const auto &street : streets)
+    {
+        if (!street.queue.empty()) return true;
+    }
+
+    return false;
+}
+
+Cross* Cross::getNeighbour(const int which) const
+{
+    const Driveable *street = streets[which].street;
+    return streets[which].direction ? street->crossEnd : street->crossBeg;
+}
+
+int Cross::getIncomingLane(const int which) const
+{
+    return streets[which].street->getLaneIndex(!streets[which].direction);
+}
+
+int Cross::getOutgoingLane(const int which) const
+{
+    return streets[which].street->getLaneIndex(streets[which].direction);
+}
+
+Vehicle* Cross::getFirstWaiting(const int which) const
+{
+    return simulation->getVehicleStore().owner[streets[which].queue.front()];
+}
+
+//Lets the first vehicle of the approach into the intersection
+void Cross::passFirstWaiting(const int which)
+{
+    getFirstWaiting(which)->allowToCross();
+    streets[which].queue.pop();
+    allowedVeh++;
+}
+
 void Cross::tryPassVehiclesWithRightOfWay()
 {
-    vector<int> indexesToPass;
+    //approaches whose first vehicle may go, decided for all of them before any is let through
+    uint32_t toPass = 0;
 
     if (streets.size() == 2)
     {
         for(unsigned int i=0;i<streets.size();i++)
         {
-            if (streets[i].vehicles.size() > 0)
-            {
-                indexesToPass.push_back(i);
-            }
+            if (!streets[i].queue.empty()) toPass |= 1u << i;
         }
     }
 
     else if (streets.size() > 2)
-    for (unsigned int i=0;i<streets.size();i++)
     {
-        if (streets[i].vehicles.size() > 0)
+        const uint32_t occupied = getOccupiedMask();
+
+        for (unsigned int i=0;i<streets.size();i++)
         {
-            if (dontCheckStreet(i)) continue;
-            if (streets[i].vehicles[0]->getDstToCross() > 1.2) continue;
+            if (!streets[i].queue.empty())
+            {
+                if (dontCheckStreet(i)) continue;
 
-            int which = streets[i].vehicles[0]->desiredTurn;
-            vector<int> yielding = streets[i].yield[which];
-            bool isOK = true;
+                Vehicle *first = getFirstWaiting(i);
+                if (first->getDstToCross() > 1.2) continue;
 
-            for (unsigned int j = 0; j < yielding.size(); j++)
-            {
-                if (streets[yielding[j]].vehicles.size() > 0 && !dontCheckStreet(yielding[j]))
+                if ((conflicts[i * streets.size() + first->desiredTurn] & occupied) == 0)
                 {
-                    isOK = false;
-                    break;
+                    toPass |= 1u << i;
                 }
             }
-
-            if (isOK)
-            {
-                indexesToPass.push_back(i);
-            }
         }
     }
 
-    for (unsigned int i=0;i<indexesToPass.size();i++)
+    for (unsigned int i=0;i<streets.size();i++)
     {
-        if (streets[indexesToPass[i]].vehicles[0]->isEnoughSpace())
+        if ((toPass & (1u << i)) && getFirstWaiting(i)->isEnoughSpace())
         {
-            streets[indexesToPass[i]].vehicles[0]->allowedToCross = true;
-            streets[indexesToPass[i]].vehicles.erase(streets[indexesToPass[i]].vehicles.begin());
-            allowedVeh++;
+            passFirstWaiting(i);
         }
     }
 }
 
+//Streets with waiting vehicles which are allowed to go (by the lights, if any)
+uint32_t Cross::getOccupiedMask()
+{
+    uint32_t occupied = 0;
+
+    for (unsigned int i=0;i<streets.size();i++)
+    {
+        if (!streets[i].queue.empty() && !dontCheckStreet(i)) occupied |= 1u << i;
+    }
+
+    return occupied;
+}
+
 void Cross::tryPassAnyVehicle()
 {
     for(unsigned int i=0;i<streets.size();i++)
     {
         if (dontCheckStreet(i)) continue;
-        if (streets[i].vehicles.size() > 0 && streets[i].vehicles[0]->dstToCross < 0.7)
+        if (!streets[i].queue.empty() && getFirstWaiting(i)->getDstToCross() < 0.7)
         {
-            if (streets[i].vehicles[0]->isEnoughSpace())
+            if (getFirstWaiting(i)->isEnoughSpace())
             {
-                streets[i].vehicles[0]->allowedToCross = true;
-                streets[i].vehicles.erase(streets[i].vehicles.begin());
-                allowedVeh++;
+                passFirstWaiting(i);
 
                 break;
             }
@@ -281,103 +341,80 @@ void Cross::tryPassAnyVehicle()
     }
 }
 
-void Cross::setDefaultPriority(Driveable *s0, Driveable *s1, Driveable *s2, Driveable *s3)
+//Orders the streets as given (when given) and compiles the conflict matrix. Streets
+//are numbered counterclockwise starting from the main road; a vehicle coming from
+//street i and turning into the street r positions further yields to all the streets
+//between them, i+1 ... i+r-1. For three and four streets this gives the classic
+//rules, e.g. at a four way junction turning left means yielding to the right and to
+//the opposite street.
+
+void Cross::setDefaultPriority(const vector<Driveable*> &order)
 {
-    isSet = true;
+    const int n = streets.size();
 
-    for(unsigned int i=0;i<streets.size();i++)
+    if (n < 2 || n > MAX_STREETS)
     {
-        streets[i].yield.clear();
+        throw ExceptionClass("incorrect number of streets at intersection " + getName());
     }
 
-    if (streets.size() == 2)
+    if (order.size() > 0 && n > 2)
     {
+        vector<OneStreet> tempVector;
 
-    }
-    else if (streets.size() == 3)
-    {
-        vector<int> yield0;
-        yield0.push_back(1);
-        vector<int> yield0empty;
-        vector<vector<int> > finalVec0;
-        finalVec0.push_back(yield0);
-        finalVec0.push_back(yield0empty);
-        finalVec0.push_back(yield0);
-
-        vector<int> yield1;
-        vector<int> yield1empty;
-        yield1.push_back(2);
-        vector<vector<int> > finalVec1;
-        finalVec1.push_back(yield1);
-        finalVec1.push_back(yield1);
-        finalVec1.push_back(yield1empty);
-
-        vector<int> yield2;
-        vector<int> yield2empty;
-        yield2.push_back(0);
-        vector<vector<int> >finalVec2;
-        finalVec2.push_back(yield2empty);
-        finalVec2.push_back(yield2);
-        //yield2.push_back(1);
-        finalVec2.push_back(yield2);
-
-        for(int i=0;i<3;i++)
+        for (auto &street : order)
         {
-            if (streets[i].street == s0) streets[i].yield = finalVec0;
-            if (streets[i].street == s1) streets[i].yield = finalVec1;
-            if (streets[i].street == s2) streets[i].yield = finalVec2;
+            auto found = find_if(streets.begin(), streets.end(), [street] (const OneStreet &item) {return item.street == street;});
+            if (found == streets.end()) throw ExceptionClass("street " + street->getName() + " does not lead to intersection " + getName());
+
+            tempVector.push_back(*found);
         }
+
+        streets = tempVector;
     }
 
-    else if (streets.size() == 4)
-    {
-        vector<int> yield[4];
+    conflicts.assign(n * n, 0);
 
-        //yield[0].push_back(1);
-        //yield[0].push_back(2);
-        //yield[1].push_back(1);
+    for (int i = 0; i < n; i++)
+    for (int r = 1; r < n; r++)
+    {
+        uint32_t mask = 0;
 
-        yield[2].push_back(1);
+        for (int k = 1; k < r; k++)
+        {
+            mask |= 1u << ((i + k) % n);
+        }
 
-        yield[3].push_back(1);
-        yield[3].push_back(2);
+        conflicts[i * n + (i + r) % n] = mask;
+    }
 
-        vector<vector<int> > finalVec;
+    buildPaths();
 
-        finalVec.push_back(yield[0]);
-        finalVec.push_back(yield[1]);
-        finalVec.push_back(yield[2]);
-        finalVec.push_back(yield[3]);
+    isSet = true;
+}
 
-        vector<OneStreet> tempVector = streets;
-        for (int i = 0; i < 4; i++)
-        {
-            if (streets[i].street == s0) tempVector[0] = streets[i];
-            if (streets[i].street == s1) tempVector[1] = streets[i];
-            if (streets[i].street == s2) tempVector[2] = streets[i];
-            if (streets[i].street == s3) tempVector[3] = streets[i];
-        }
-        streets = tempVector;
+//Vehicles come to the intersection along the lane of the approach street leading to
+//it and leave it along the lane of the turn street leading away from it
+void Cross::buildPaths()
+{
+    const int n = streets.size();
 
-        for (int i = 0; i < 4; i++)
-        {
-            streets[i].yield = finalVec;
+    paths.assign(n * n, CurvePath());
 
-            rotate(streets[i].yield.begin(), streets[i].yield.begin() + (-i + 4)%4 , streets[i].yield.end());
-            for(int j = 0; j < 4; j++)
-            for(unsigned int k = 0; k < streets[i].yield[j].size(); k++)
-            {
-                streets[i].yield[j][k]+= i;
-                streets[i].yield[j][k]%=4;
-            }
-        }
-    }
-    else
+    for (int i = 0; i < n; i++)
+    for (int t = 0; t < n; t++)
     {
-        throw ExceptionClass("incorrect number of streets at intersection " + id);
+        const Driveable::LaneGeometry &from = streets[i].street->getLaneGeometry(!streets[i].direction);
+        const Driveable::LaneGeometry &to = streets[t].street->getLaneGeometry(streets[t].direction);
+
+        paths[i * n + t].build(from.exit, to.entry, from.direction, to.direction);
     }
 }
 
+const CurvePath& Cross::getPath(const int approach, const int turn) const
+{
+    return paths[approach * streets.size() + turn];
+}
+
 Vec3 Cross::OneStreet::getJointPos()
 {
     return street->getJointPoint(direction);
@@ -389,10 +426,10 @@ void Cross::draw()
     drawTile(0.6);
 }
 
-void CrossLights::setDefaultPriority(Driveable *s0, Driveable *s1, Driveable *s2, Driveable *s3)
+void CrossLights::setDefaultPriority(const vector<Driveable*> &order)
 {
-    Cross::setDefaultPriority(s0, s1, s2, s3);
-    setDefaultLights(s0, s1, s2, s3);
+    Cross::setDefaultPriority(order);
+    setDefaultLights();
 }
 
 bool CrossLights::dontCheckStreet(const int which)
@@ -400,38 +437,30 @@ bool CrossLights::dontCheckStreet(const int which)
     return !curPriority[which];
 }
 
-void CrossLights::setDefaultLights(Driveable *s0, Driveable *s1, Driveable *s2, Driveable *s3)
+//First phase is green for the main road and every second street after it, the
+//second phase for the rest; at a three way junction only the main road goes first
+
+void CrossLights::setDefaultLights()
 {
     defaultPriority.clear();
     curPriority.clear();
 
-    for (unsigned int i=0;i<streets.size();i++)
+    if (streets.size() < 3)
     {
-        defaultPriority.push_back(false);
-        curPriority.push_back(false);
+        throw ExceptionClass("incorrect number of streets at intersection " + getName());
     }
 
-    if (streets.size() == 3)
+    for (unsigned int i=0;i<streets.size();i++)
     {
-        //defaultPriority[0] = true;
-        for (unsigned int i=0;i<streets.size();i++)
-        {
-            if (streets[i].street == s0) defaultPriority[i] = true;
-        }
-    }
+        if (streets.size() == 3)
+            defaultPriority.push_back(i == 0);
+        else
+            defaultPriority.push_back(i % 2 == 0 && i + 1 < streets.size());
 
-    else if (streets.size() == 4)
-    {
-        for (unsigned int i=0;i<streets.size();i++)
-        {
-            if (streets[i].street == s0) defaultPriority[i] = true;
-            if (streets[i].street == s2) defaultPriority[i] = true;
-        }
-    }
-    else
-    {
-        throw ExceptionClass("incorrect number of streets at intersection " + id);
+        curPriority.push_back(false);
     }
+
+    setLightsPriority();
 }
 
 void CrossLights::setLightsPriority()
@@ -461,15 +490,25 @@ void CrossLights::setLightsPriority()
     }
 }
 
-CrossLights::CrossLights(Vec3 position) : Cross(position)
+CrossLights::CrossLights(Simulation *sim, Vec3 position) : Cross(sim, position)
 {
     setLightsDurations();
 
     curState = B1;
-    curTime = durLight.durationBreak;
+    shownState = B1;
     setLightsPriority();
 }
 
+int CrossLights::getState() const
+{
+    return curState;
+}
+
+void CrossLights::showState(const int state)
+{
+    shownState = (State)state;
+}
+
 void CrossLights::setLightsDurations()
 {
     durLight.durationGreen1 = randFloat(10, 20);
@@ -479,61 +518,29 @@ void CrossLights::setLightsDurations()
     durLight.durationBreak = randFloat(1, 6);
 }
 
-void CrossLights::getNextState()
+void CrossLights::nextPhase()
 {
-    if (curTime <= 0)
+    static const State next[] = {Y1, B1, G2, Y2, B2, G1};
+
+    curState = next[curState];
+    setLightsPriority();
+}
+
+float CrossLights::getPhaseDuration() const
+{
+    switch (curState)
     {
-        if (curState == G1)
-        {
-            curState = Y1;
-            curTime = durLight.durationYellow1;
-            setLightsPriority();
-            return;
-        }
-        if (curState == Y1)
-        {
-            curState = B1;
-            curTime = durLight.durationBreak;
-            setLightsPriority();
-            return;
-        }
-        if (curState == B1)
-        {
-            curState = G2;
-            curTime = durLight.durationGreen2;
-            setLightsPriority();
-            return;
-        }
-        if (curState == G2)
-        {
-            curState = Y2;
-            curTime = durLight.durationYellow2;
-            setLightsPriority();
-            return;
-        }
-        if (curState == Y2)
-        {
-            curState = B2;
-            curTime = durLight.durationBreak;
-            setLightsPriority();
-            return;
-        }
-        if (curState == B2)
-        {
-            curState = G1;
-            curTime = durLight.durationGreen1;
-            setLightsPriority();
-            return;
-        }
+        case G1: return durLight.durationGreen1;
+        case Y1: return durLight.durationYellow1;
+        case G2: return durLight.durationGreen2;
+        case Y2: return durLight.durationYellow2;
+        default: return durLight.durationBreak;
     }
 }
 
 void CrossLights::update(const float delta)
 {
     updateCross(delta);
-
-    curTime -= delta;
-    getNextState();
 }
 
 void CrossLights::draw()
@@ -543,28 +550,28 @@ void CrossLights::draw()
     Vec3 color1;
     Vec3 color2;
 
-    if (curState == G1)
+    if (shownState == G1)
     {
         color1 = Vec3(0,1,0);
         color2 = Vec3(1,0,0);
     }
-    if (curState == G2)
+    if (shownState == G2)
     {
         color1 = Vec3(1,0,0);
         color2 = Vec3(0,1,0);
     }
-    if (curState == Y1)
+    if (shownState == Y1)
     {
         color1 = Vec3(1,1,0);
         color2 = Vec3(1,0,0);
     }
 
-    if (curState == Y2)
+    if (shownState == Y2)
     {
         color1 = Vec3(1,0,0);
         color2 = Vec3(1,1,0);
     }
-    if (curState == B1 || curState == B2 )
+    if (shownState == B1 || shownState == B2 )
     {
         color1 = Vec3(1,0,0);
         color2 = Vec3(1,0,0);
@@ -606,7 +613,7 @@ void CrossLights::draw()
     }
 }
 
-Street::Street(Cross *begCross, Cross *endCross) : Driveable(begCross, endCross)
+Street::Street(Simulation *sim, Cross *begCross, Cross *endCross) : Driveable(sim, begCross, endCross)
 {
 
 }
@@ -15,19 +15,22 @@
 #include "EngineCore/ExceptionClass.h"
 #include "GameObject.h"
 #include "Vehicle.h"
+#include "SlotRing.h"
+#include "CurvePath.h"
 #include <sstream>
 #include <algorithm>
 
 class Cross;
 class Vehicle;
-class Simulator;
+class Simulation;
 class ObjectsLoader;
 
 class Road : public GameObject
 {
 public:
-    static Vec3 roadColor;
+    static const Vec3 roadColor;
 protected:
+    Road(Simulation *sim);
     virtual ~Road(){};
 };
 
@@ -38,28 +41,38 @@ public:
     Vec3 getNormal() const;
     Vec3 getDirection() const;
     float getLength() const;
+    int getLaneIndex(const bool dir) const;
 
 protected:
-    Driveable(Cross *begCross, Cross *endCross);
-    Driveable(Vec3 p, Cross *endCross);
+    Driveable(Simulation *sim, Cross *begCross, Cross *endCross);
+    Driveable(Simulation *sim, Vec3 p, Cross *endCross);
     virtual ~Driveable(){};
 
-    std::queue<Vehicle*> vehiclesBeg;
-    std::queue<Vehicle*> vehiclesEnd;
-
     Vec3 begPos;
     Vec3 endPos;
 
     Vec3 begJoint;
     Vec3 endJoint;
 
-    Vec3 getBegJointWidth(const bool dir) const;
-    Vec3 getEndJointWidth(const bool dir) const;
+    const SlotRing& getLane(const bool dir) const;
+
+    //lane geometry, cached when the road is built; the lane of direction dir is
+    //entered at its entry point and left at its exit point
+    struct LaneGeometry
+    {
+        Vec3 entry;
+        Vec3 exit;
+        Vec3 direction;
+        float heading;
+    };
+
+    const LaneGeometry& getLaneGeometry(const bool dir) const;
 
     Vec3 direction;
     Vec3 normal;
 
     float length;
+    int roadIndex;
 
     virtual float freeSpace(const bool dir) const;
 
@@ -69,18 +82,19 @@ protected:
     void draw();
 
 private:
-    float reservedSpaceBeg;
-    float reservedSpaceEnd;
+    LaneGeometry laneGeometry[2];
 
     void commonConstructor();
+    void cacheLaneGeometry();
 
     friend Vehicle;
+    friend Cross;
 };
 
 class Street : public Driveable
 {
 public:
-    Street(Cross *begCross, Cross *endCross);
+    Street(Simulation *sim, Cross *begCross, Cross *endCross);
 
 private:
     void draw();
@@ -89,8 +103,11 @@ private:
 class Cross : public Road
 {
 public:
-    Cross(Vec3 position);
-    virtual void setDefaultPriority(Driveable *s0 = nullptr, Driveable *s1 = nullptr, Driveable *s2 = nullptr, Driveable *s3 = nullptr);
+    Cross(Simulation *sim, Vec3 position);
+    virtual void setDefaultPriority(const std::vector<Driveable*> &order = std::vector<Driveable*>());
+
+    //streets of an intersection are bits of the conflict masks
+    static const int MAX_STREETS = 32;
 
 protected:
     virtual ~Cross(){};
@@ -98,40 +115,70 @@ protected:
     struct OneStreet
     {
         Driveable *street;
-        std::vector<Vehicle*> vehicles;
+        SlotRing queue;     //store slots of the vehicles waiting on this approach
         bool direction;
         Vec3 getJointPos();
-
-        std::vector<std::vector<int> > yield;
     };
     std::vector<OneStreet> streets;
 
+    //conflicts[approach * streets.size() + turn] - mask of the streets which a vehicle
+    //coming from the approach and turning into the turn street has to yield to
+    std::vector<uint32_t> conflicts;
+
+    //paths[approach * streets.size() + turn] - path of the vehicles coming from the
+    //approach and turning into the turn street
+    std::vector<CurvePath> paths;
+
+    uint32_t getOccupiedMask();
+    const CurvePath& getPath(const int approach, const int turn) const;
+    Vehicle* getFirstWaiting(const int which) const;
+    void passFirstWaiting(const int which);
+
     virtual void updateCross(const float delta);
     virtual bool dontCheckStreet(const int which);
 
     virtual void tryPassVehiclesWithRightOfWay();
     virtual void tryPassAnyVehicle();
 
+    void addWaitingVehicle(const int street, Vehicle *vehicle);
+    bool hasWaitingVehicles() const;
+
     void draw();
 
 private:
     bool isSet;
     int allowedVeh;
 
+    //intersection is in the list of active intersections of its region
+    bool isActive;
+    int region;
+
+    //other end of a street, nullptr for a garage
+    Cross* getNeighbour(const int which) const;
+    int getIncomingLane(const int which) const;
+    int getOutgoingLane(const int which) const;
+
     bool checkSet();
+    void buildPaths();
     void update(const float delta);
 
     friend Driveable;
     friend Vehicle;
     friend ObjectsLoader;
+    friend Simulation;
 };
 
 class CrossLights : public Cross
 {
 public:
-    CrossLights(Vec3 position);
+    CrossLights(Simulation *sim, Vec3 position);
     void setLightsDurations();
 
+    //state of the lights is read for a frame snapshot and drawn from the snapshot,
+    //so drawing never reads the state changed by the simulation
+    int getState() const;
+    void showState(const int state);
+
     struct LightsDuration
     {
         float durationGreen1;
@@ -145,20 +192,24 @@ private:
     std::vector<bool> defaultPriority;
     std::vector<bool> curPriority;
 
-    void setDefaultPriority(Driveable *s0 = NULL, Driveable *s1 = NULL, Driveable *s2 = NULL, Driveable *s3 = NULL);
-    void setDefaultLights(Driveable *s0, Driveable *s1, Driveable *s2, Driveable *s3);
+    void setDefaultPriority(const std::vector<Driveable*> &order = std::vector<Driveable*>());
+    void setDefaultLights();
     void setLightsPriority();
 
-    float curTime;
-
     enum State{G1, Y1, B1, G2, Y2, B2};
     State curState;
-    void getNextState();
+    State shownState;
+
+    //phases are changed by the timers of the simulation, when their time is up
+    void nextPhase();
+    float getPhaseDuration() const;
 
     bool dontCheckStreet(const int which);
 
     void update(const float delta);
     void draw();
+
+    friend Simulation;
 };
 
 #endif // STREET_H
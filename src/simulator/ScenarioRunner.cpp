@@ -0,0 +1,97 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: ScenarioRunner.cpp
+
+
+#include "ScenarioRunner.h"
+#include "EngineCore/ThreadPool.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+ScenarioRunner::ScenarioRunner(const int threadsNumber)
+{
+    threads = threadsNumber;
+}
+
+void ScenarioRunner::addScenario(const BatchConfig &config)
+{
+    scenarios.push_back(config);
+}
+
+void ScenarioRunner::run()
+{
+    runners.clear();
+    errors.assign(scenarios.size(), string());
+
+    for (const auto &scenario : scenarios)
+    {
+        runners.push_back(BatchRunner(scenario, false));
+    }
+
+    ThreadPool pool(threads);
+
+    cout << "Running " << scenarios.size() << " scenarios on " << pool.getThreadsNumber() << " threads" << endl;
+
+    chrono::steady_clock::time_point begTime = chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < runners.size(); i++)
+    {
+        pool.enqueue([this, i] ()
+        {
+            try
+            {
+                runners[i].run();
+            }
+            catch (ExceptionClass e)
+            {
+                errors[i] = e.what();
+            }
+            catch (const exception &e)
+            {
+                //anything else escaping the thread would terminate all scenarios
+                errors[i] = string("unexpected error: ") + e.what();
+            }
+        });
+    }
+
+    pool.wait();
+
+    double wallTime = chrono::duration<double>(chrono::steady_clock::now() - begTime).count();
+    if (wallTime <= 0) wallTime = 1e-9;
+
+    long long totalTicks = 0;
+    long long totalVehicleUpdates = 0;
+    double totalSimulatedTime = 0;
+
+    for (unsigned int i = 0; i < runners.size(); i++)
+    {
+        cout << "scenario " << i << " (seed " << scenarios[i].seed << ", " << scenarios[i].outputDir << "): ";
+
+        if (!errors[i].empty())
+        {
+            cout << "ERROR: " << errors[i] << endl;
+            continue;
+        }
+
+        cout << runners[i].getTicks() << " ticks, " << runners[i].getVehicleUpdates() << " vehicle updates in ";
+        cout << runners[i].getWallTime() << " s" << endl;
+
+        totalTicks += runners[i].getTicks();
+        totalVehicleUpdates += runners[i].getVehicleUpdates();
+        totalSimulatedTime += runners[i].getSimulatedTime();
+    }
+
+    cout << "wall time:           " << wallTime << " s" << endl;
+    cout << "ticks per second:    " << totalTicks / wallTime << endl;
+    cout << "vehicle updates/s:   " << totalVehicleUpdates / wallTime << endl;
+    cout << "simulated s/wall s:  " << totalSimulatedTime / wallTime << endl;
+}
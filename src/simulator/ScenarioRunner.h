@@ -0,0 +1,39 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: ScenarioRunner.h
+
+
+#ifndef SCENARIORUNNER_H
+#define SCENARIORUNNER_H
+
+#include <vector>
+#include <string>
+
+#include "BatchRunner.h"
+
+//Runs many independent batch scenarios at once - each scenario has its own
+//Simulation instance and is executed by one thread of the pool
+
+class ScenarioRunner
+{
+public:
+    ScenarioRunner(const int threadsNumber = 0);
+
+    void addScenario(const BatchConfig &config);
+    void run();
+
+private:
+    int threads;
+
+    std::vector<BatchConfig> scenarios;
+    std::vector<BatchRunner> runners;
+    std::vector<std::string> errors;
+};
+
+#endif // SCENARIORUNNER_H
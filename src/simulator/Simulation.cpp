@@ -0,0 +1,654 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Simulation.cpp
+
+#include "Simulation.h"
+#include "EngineCore/WorkStealingPool.h"
+#include "EngineCore/Cluster.h"
+
+#include <queue>
+#include <algorithm>
+using namespace std;
+
+const double Simulation::TIMER_RESOLUTION = 1.0 / 64;
+
+Simulation::Simulation(const unsigned int randomSeed) : timers(TIMER_RESOLUTION), pool(vehicles)
+{
+    maxNumberOfObjects = 0;
+    time = 0;
+    isNetworkReady = false;
+    workers = nullptr;
+    cluster = nullptr;
+
+    seed = randomSeed;
+    for (int i = 0; i < RandomStream::STREAM_KINDS; i++)
+        streamsCounter[i] = 0;
+}
+
+Simulation::~Simulation()
+{
+    cleanSimulation();
+    delete workers;
+}
+
+void Simulation::setWorkers(const int threadsNumber)
+{
+    delete workers;
+    workers = nullptr;
+
+    if (threadsNumber > 1) workers = new WorkStealingPool(threadsNumber);
+}
+
+void Simulation::setCluster(Cluster *nodes)
+{
+    cluster = nodes;
+    isNetworkReady = false;
+}
+
+//Every phase of a tick is run for all regions of the network independently and
+//the phases are separated by barriers. Vehicles interact with other regions only
+//through the space left at the beginning of lanes, which is fixed for the whole
+//transition phase, and by moving to the next lane, which is done at the end of the
+//tick - so the results don't depend on the regions or on the number of workers.
+//
+//The same two points are the only ones where the processes of a distributed
+//simulation have to meet: lane tails after the car following and vehicles moving
+//to lanes of other processes at the end of the tick.
+
+void Simulation::step(const float delta)
+{
+    if (!isNetworkReady) prepareNetwork();
+
+    spawnAndDespawn();
+
+    runRegions([this, delta] (int r) { updateCrosses(r, delta); });
+
+    updateTimers(delta);
+
+    runRegions([this, delta] (int r) { vehicles.updateDriving(r, delta); });
+    vehicles.swapPositions();
+
+    if (cluster != nullptr) exchangeTails();
+
+    runRegions([this, delta] (int r) { vehicles.updateTransitions(r, delta); });
+    vehicles.commitMoves();
+
+    if (cluster != nullptr) exchangeVehicles();
+
+    watchArrivals(delta);
+
+    time += delta;
+}
+
+//Garages made ready by their timers, in the order of the garages
+void Simulation::spawnAndDespawn()
+{
+    if (readyGarages.empty()) return;
+
+    vector<Garage*> ready;
+    ready.swap(readyGarages);
+
+    sort(ready.begin(), ready.end(), [] (const Garage *a, const Garage *b) { return a->garageIndex < b->garageIndex; });
+    ready.erase(unique(ready.begin(), ready.end()), ready.end());
+
+    for (auto &spot : ready)
+    {
+        if (spot->checkReadyToSpot())
+        {
+            spot->spotVeh();
+            exitWatch.push_back(spot);
+        }
+
+        if (spot->checkReadyToDelete())
+        {
+            spot->deleteVeh();
+
+            if (spot->hasVehiclesInside()) scheduleGarage(spot, GARAGE_DELETE, time + spot->frecDelete);
+
+            //a full garage spawns as soon as one of its vehicles is gone
+            if (spot->spotState == Garage::FULL)
+            {
+                spot->spotState = Garage::READY;
+                readyGarages.push_back(spot);
+            }
+        }
+    }
+}
+
+//Time to spawn runs from the tick in which the exit is found clear, the events of
+//a tick are the ones due by its end
+void Simulation::updateTimers(const float delta)
+{
+    unsigned int i = 0;
+
+    while (i < exitWatch.size())
+    {
+        Garage *spot = exitWatch[i];
+
+        if (spot->isExitClear())
+        {
+            scheduleGarage(spot, GARAGE_SPOT, time + spot->frecSpot);
+
+            exitWatch[i] = exitWatch.back();
+            exitWatch.pop_back();
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    const double now = time + delta;
+
+    timers.advance(now, firedTimers);
+
+    for (auto id : firedTimers)
+    {
+        const int index = id / TIMER_KINDS;
+
+        switch (id % TIMER_KINDS)
+        {
+            case LIGHTS_PHASE:
+            {
+                CrossLights *lights = localSignals[index];
+                lights->nextPhase();
+                timers.schedule(now + lights->getPhaseDuration(), id);
+                break;
+            }
+            case GARAGE_SPOT:
+            {
+                Garage *spot = spots[index];
+                spot->spotState = spot->spottedVehicles < spot->maxVehicles ? Garage::READY : Garage::FULL;
+                if (spot->spotState == Garage::READY) readyGarages.push_back(spot);
+                break;
+            }
+            case GARAGE_DELETE:
+            {
+                Garage *spot = spots[index];
+                spot->deleteState = Garage::READY;
+                readyGarages.push_back(spot);
+                break;
+            }
+        }
+    }
+
+    firedTimers.clear();
+}
+
+//Time to despawn runs from the tick after a vehicle has entered an empty garage
+void Simulation::watchArrivals(const float delta)
+{
+    vector<int> &entered = vehicles.getEnteredLanes();
+
+    for (auto l : entered)
+    {
+        Garage *spot = spots[laneGarage[l]];
+        if (spot->deleteState == Garage::WAITING) scheduleGarage(spot, GARAGE_DELETE, time + delta + spot->frecDelete);
+    }
+
+    entered.clear();
+}
+
+void Simulation::scheduleGarage(Garage *garage, const TimerKind kind, const double due)
+{
+    if (kind == GARAGE_SPOT)
+        garage->spotState = Garage::COUNTING;
+    else
+        garage->deleteState = Garage::COUNTING;
+
+    timers.schedule(due, garage->garageIndex * TIMER_KINDS + kind);
+}
+
+//Timers of the lights and garages updated by this node; every garage starts waiting
+//for a clear exit, and its entrance is watched for arriving vehicles
+void Simulation::startTimers()
+{
+    timers.clear();
+    readyGarages.clear();
+    exitWatch.clear();
+    vehicles.getEnteredLanes().clear();
+
+    for (unsigned int i = 0; i < localSignals.size(); i++)
+    {
+        timers.schedule(time + localSignals[i]->getPhaseDuration(), i * TIMER_KINDS + LIGHTS_PHASE);
+    }
+
+    laneGarage.assign(vehicles.getLanesNumber(), -1);
+
+    for (auto &spot : localSpots)
+    {
+        if (spots[spot->garageIndex] != spot) throw ExceptionClass("garages are not in the order of their indexes");
+
+        spot->spotState = Garage::WAITING;
+        spot->deleteState = Garage::WAITING;
+        exitWatch.push_back(spot);
+
+        const int laneIn = spot->getLaneIndex(false);
+        laneGarage[laneIn] = spot->garageIndex;
+        vehicles.watchLane(laneIn, true);
+
+        if (spot->hasVehiclesInside()) scheduleGarage(spot, GARAGE_DELETE, time + spot->frecDelete);
+    }
+}
+
+void Simulation::runRegions(const function<void(int)> &task)
+{
+    if (workers != nullptr)
+    {
+        workers->run(localRegions.size(), [this, &task] (int i) { task(localRegions[i]); });
+        return;
+    }
+
+    for (auto r : localRegions)
+    {
+        task(r);
+    }
+}
+
+//Tails of the lanes entered from the intersections of other nodes, as left by the
+//car following, for their transitions
+
+void Simulation::exchangeTails()
+{
+    const int nodes = cluster->getNodesNumber();
+    vector<Message> out(nodes), in;
+
+    for (int k = 0; k < nodes; k++)
+    {
+        for (auto l : tailsOut[k])
+        {
+            out[k].put(vehicles.getLaneTail(l));
+        }
+    }
+
+    cluster->exchange(out, in);
+
+    for (int k = 0; k < nodes; k++)
+    {
+        for (auto l : tailsIn[k])
+        {
+            vehicles.setLaneTail(l, in[k].get<float>());
+        }
+    }
+}
+
+//Vehicles which moved to lanes of other nodes are sent there and destroyed here.
+//Together with them go the tails of the boundary lanes after the vehicles that
+//left them this tick; the tail of a lane just entered from here is already right.
+
+void Simulation::exchangeVehicles()
+{
+    const int nodes = cluster->getNodesNumber();
+    vector<Message> out(nodes), in;
+
+    for (int k = 0; k < nodes; k++)
+    {
+        for (auto l : tailsOut[k])
+        {
+            out[k].put(vehicles.getLaneTail(l));
+        }
+    }
+
+    vector<VehicleStore::Departure> &departures = vehicles.getDepartures();
+
+    for (auto &departure : departures)
+    {
+        Vehicle *vehicle = vehicles.owner[departure.slot];
+        Message &message = out[regionNode[laneRegion[departure.toLane]]];
+
+        message.put(departure.toLane);
+        message.put(vehicles.kind[departure.slot]);
+        message.put(vehicle->getRoad()->id);
+        vehicle->saveState(message);
+
+        pool.destroy(vehicle);
+        laneEntered[departure.toLane] = true;
+    }
+
+    cluster->exchange(out, in);
+
+    for (int k = 0; k < nodes; k++)
+    {
+        for (auto l : tailsIn[k])
+        {
+            const float tail = in[k].get<float>();
+            if (!laneEntered[l]) vehicles.setLaneTail(l, tail);
+        }
+
+        while (!in[k].atEnd())
+        {
+            receiveVehicle(in[k]);
+        }
+    }
+
+    for (auto &departure : departures)
+    {
+        laneEntered[departure.toLane] = false;
+    }
+
+    departures.clear();
+}
+
+void Simulation::receiveVehicle(Message &message)
+{
+    const int toLane = message.get<int>();
+    const unsigned char kind = message.get<unsigned char>();
+    const int roadId = message.get<int>();
+
+    Driveable *road = nullptr;
+    if (roadId >= 0 && roadId < (int)objectsById.size()) road = dynamic_cast<Driveable*>(objectsById[roadId]);
+    if (road == nullptr || toLane < 0 || toLane >= vehicles.getLanesNumber()) throw ExceptionClass("received vehicle on an unknown road");
+
+    Vehicle *vehicle;
+    if (kind == VehicleStore::BUS)
+        vehicle = pool.create<Bus>(this, road, RandomStream());
+    else
+        vehicle = pool.create<Car>(this, road, RandomStream());
+
+    vehicle->loadState(message, toLane);
+}
+
+//Default right of way of intersections not set by a right of way file; done before
+//the first tick, as intersections are visited only when vehicles wait at them
+
+void Simulation::prepareNetwork()
+{
+    for (auto &cross : crosses)
+    {
+        cross->checkSet();
+    }
+
+    partition();
+
+    isNetworkReady = true;
+}
+
+//Road network is split into regions of REGION_CROSSES connected intersections, each
+//grown breadth first from the first intersection not assigned yet. A region owns
+//the lanes leading to its intersections and the lanes from them to garages, so a
+//vehicle is updated by the region of the intersection it is driving to.
+
+void Simulation::partition()
+{
+    for (auto &cross : crosses)
+    {
+        cross->region = -1;
+    }
+
+    int regionsNumber = 0;
+
+    for (auto &start : crosses)
+    {
+        if (start->region >= 0) continue;
+
+        queue<Cross*> toVisit;
+        int size = 0;
+
+        start->region = regionsNumber;
+        toVisit.push(start);
+
+        while (!toVisit.empty() && size < REGION_CROSSES)
+        {
+            Cross *cross = toVisit.front();
+            toVisit.pop();
+            size++;
+
+            for (unsigned int i = 0; i < cross->streets.size(); i++)
+            {
+                Cross *next = cross->getNeighbour(i);
+
+                if (next != nullptr && next->region < 0 && size + (int)toVisit.size() < REGION_CROSSES)
+                {
+                    next->region = regionsNumber;
+                    toVisit.push(next);
+                }
+            }
+        }
+
+        regionsNumber++;
+    }
+
+    if (regionsNumber == 0) regionsNumber = 1;
+
+    regions.assign(regionsNumber, Region());
+    laneRegion.assign(vehicles.getLanesNumber(), 0);
+
+    for (auto &cross : crosses)
+    {
+        Region &region = regions[cross->region];
+
+        if (cross->isActive) region.activeCrosses.push_back(cross);
+
+        CrossLights *lights = dynamic_cast<CrossLights*>(cross);
+        if (lights != nullptr) region.signals.push_back(lights);
+
+        for (unsigned int i = 0; i < cross->streets.size(); i++)
+        {
+            laneRegion[cross->getIncomingLane(i)] = cross->region;
+            if (cross->getNeighbour(i) == nullptr) laneRegion[cross->getOutgoingLane(i)] = cross->region;
+        }
+    }
+
+    vehicles.setRegions(laneRegion, regionsNumber);
+
+    assignNodes();
+}
+
+//Regions are dealt out to the nodes of a cluster in contiguous blocks - being grown
+//one after another, neighbouring regions mostly go to the same node
+
+void Simulation::assignNodes()
+{
+    const int nodes = cluster != nullptr ? cluster->getNodesNumber() : 1;
+    const int node = cluster != nullptr ? cluster->getNode() : 0;
+
+    regionNode.resize(regions.size());
+    localRegions.clear();
+
+    for (unsigned int r = 0; r < regions.size(); r++)
+    {
+        regionNode[r] = r * nodes / regions.size();
+        if (regionNode[r] == node) localRegions.push_back(r);
+    }
+
+    localSpots.clear();
+
+    for (auto &spot : spots)
+    {
+        if (spot->crossEnd == nullptr || regionNode[spot->crossEnd->region] == node) localSpots.push_back(spot);
+    }
+
+    localSignals.clear();
+
+    for (auto r : localRegions)
+    {
+        localSignals.insert(localSignals.end(), regions[r].signals.begin(), regions[r].signals.end());
+    }
+
+    vector<bool> remote(laneRegion.size());
+
+    for (unsigned int l = 0; l < laneRegion.size(); l++)
+    {
+        remote[l] = regionNode[laneRegion[l]] != node;
+    }
+
+    vehicles.setRemoteLanes(remote);
+    startTimers();
+    laneEntered.assign(laneRegion.size(), false);
+
+    tailsOut.assign(nodes, vector<int>());
+    tailsIn.assign(nodes, vector<int>());
+
+    for (auto &cross : crosses)
+    {
+        const int from = regionNode[cross->region];
+
+        for (unsigned int i = 0; i < cross->streets.size(); i++)
+        {
+            const int l = cross->getOutgoingLane(i);
+            const int to = regionNode[laneRegion[l]];
+
+            if (from == to) continue;
+
+            if (to == node) tailsOut[from].push_back(l);
+            if (from == node) tailsIn[to].push_back(l);
+        }
+    }
+}
+
+void Simulation::activateCross(Cross *cross)
+{
+    regions[cross->region].activeCrosses.push_back(cross);
+}
+
+//Intersections without waiting vehicles leave the active list (swap with the last one)
+void Simulation::updateCrosses(const int region, const float delta)
+{
+    vector<Cross*> &activeCrosses = regions[region].activeCrosses;
+    unsigned int i = 0;
+
+    while (i < activeCrosses.size())
+    {
+        Cross *cross = activeCrosses[i];
+        cross->updateCross(delta);
+
+        if (cross->hasWaitingVehicles())
+        {
+            i++;
+        }
+        else
+        {
+            cross->isActive = false;
+            activeCrosses[i] = activeCrosses.back();
+            activeCrosses.pop_back();
+        }
+    }
+}
+
+int Simulation::getVehiclesCount() const
+{
+    return vehicles.size();
+}
+
+double Simulation::getTime() const
+{
+    return time;
+}
+
+VehicleStore& Simulation::getVehicleStore()
+{
+    return vehicles;
+}
+
+VehiclePool& Simulation::getVehiclePool()
+{
+    return pool;
+}
+
+SymbolTable& Simulation::getSymbols()
+{
+    return symbols;
+}
+
+RandomStream Simulation::createStream(const RandomStream::StreamKind kind, const uint32_t index, const uint32_t serial) const
+{
+    return RandomStream(seed, RandomStream::makeStreamId(kind, index, serial));
+}
+
+uint32_t Simulation::nextStreamIndex(const RandomStream::StreamKind kind)
+{
+    return streamsCounter[kind]++;
+}
+
+void Simulation::reserveObjects()
+{
+    objects.reserve(maxNumberOfObjects);
+}
+
+void Simulation::registerObject(GameObject *go)
+{
+    go->objectIndex = objects.size();
+    objects.push_back(go);
+}
+
+//Swap with the last object and pop - constant time, the moved object gets its new index
+void Simulation::destroyObject(GameObject *go)
+{
+    const int index = go->objectIndex;
+    if (index < 0 || index >= (int)objects.size() || objects[index] != go) throw ExceptionClass("destroying an object which is not registered");
+
+    GameObject *last = objects.back();
+    objects[index] = last;
+    last->objectIndex = index;
+
+    objects.pop_back();
+    go->objectIndex = -1;
+
+    if (go->id >= 0 && go->id < (int)objectsById.size() && objectsById[go->id] == go) objectsById[go->id] = nullptr;
+}
+
+void Simulation::cleanSimulation()
+{
+    maxNumberOfObjects = 0;
+    time = 0;
+    isNetworkReady = false;
+
+    pool.destroyAll();
+
+    while (objects.size() > 0)
+    {
+        GameObject *go = objects.back();
+        destroyObject(go);
+        delete go;
+    }
+
+    spots.clear();
+    localSpots.clear();
+    localSignals.clear();
+    readyGarages.clear();
+    exitWatch.clear();
+    timers.clear();
+    crosses.clear();
+    regions.clear();
+    localRegions.clear();
+    symbols.clear();
+    objectsById.clear();
+}
+
+GameObject* Simulation::findObjectByName(const string objectName) const
+{
+    const int symbol = symbols.find(objectName);
+    if (symbol == SymbolTable::NONE || symbol >= (int)objectsById.size()) return nullptr;
+
+    return objectsById[symbol];
+}
+
+void Simulation::loadedNewObject(GameObject *newGameObject)
+{
+    registerObject(newGameObject);
+
+    if (newGameObject->id >= (int)objectsById.size()) objectsById.resize(newGameObject->id + 1, nullptr);
+    objectsById[newGameObject->id] = newGameObject;
+
+    Cross *cross = dynamic_cast<Cross*>(newGameObject);
+    if (cross != nullptr) crosses.push_back(cross);
+
+    maxNumberOfObjects++;
+}
+
+void Simulation::loadedNewFactory(Garage *newFactory)
+{
+    spots.push_back(newFactory);
+    maxNumberOfObjects += newFactory->maxVehicles;
+}
+
+Simulation* Simulation::getSimulation()
+{
+    return this;
+}
@@ -0,0 +1,164 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: Simulation.h
+
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "ObjectsLoader.h"
+#include "EngineCore/Random.h"
+#include "VehicleStore.h"
+#include "VehiclePool.h"
+#include "SymbolTable.h"
+#include "EngineCore/TimerWheel.h"
+
+#include <functional>
+
+class GameObject;
+class WorkStealingPool;
+class Cluster;
+class Message;
+
+//Single, fully isolated simulation context - all objects, counters and random
+//streams belong to the instance, so many simulations can run in one process
+
+class Simulation : public ObjectsLoader
+{
+    friend GameObject;
+
+public:
+    Simulation(const unsigned int randomSeed = 1);
+    virtual ~Simulation();
+
+    void step(const float delta);
+    void setWorkers(const int threadsNumber);
+    void setCluster(Cluster *nodes);
+    int getVehiclesCount() const;
+    double getTime() const;
+
+    VehicleStore& getVehicleStore();
+    VehiclePool& getVehiclePool();
+    SymbolTable& getSymbols();
+
+    void registerObject(GameObject *go);
+    void destroyObject(GameObject *go);
+
+    RandomStream createStream(const RandomStream::StreamKind kind, const uint32_t index, const uint32_t serial = 0) const;
+    uint32_t nextStreamIndex(const RandomStream::StreamKind kind);
+
+    void activateCross(Cross *cross);
+
+protected:
+    GameObject* findObjectByName(const std::string objectName) const;
+    void loadedNewObject(GameObject *newGameObject);
+    void loadedNewFactory(Garage *newFactory);
+    Simulation* getSimulation();
+
+    void reserveObjects();
+    void cleanSimulation();
+
+    //done by the first step unless called before, when nothing else may read the
+    //intersections yet
+    void prepareNetwork();
+
+    std::vector<GameObject*> objects;
+    std::vector<GameObject*> objectsById;
+    std::vector<Garage*> spots;
+
+    //type-homogeneous update lists; streets are never visited in a tick
+    std::vector<Cross*> crosses;
+
+    //intersections of one region of the road network (see partition)
+    struct Region
+    {
+        std::vector<Cross*> activeCrosses;
+        std::vector<CrossLights*> signals;
+    };
+    std::vector<Region> regions;
+
+private:
+    Simulation(const Simulation&);
+    Simulation& operator = (const Simulation&);
+
+    int maxNumberOfObjects;
+
+    bool isNetworkReady;
+
+    void partition();
+    void assignNodes();
+    void runRegions(const std::function<void(int)> &task);
+    void updateCrosses(const int region, const float delta);
+
+    //phases of lights and spawning and despawning of garages are timer events
+    enum TimerKind
+    {
+        LIGHTS_PHASE,
+        GARAGE_SPOT,
+        GARAGE_DELETE,
+        TIMER_KINDS
+    };
+
+    void startTimers();
+    void spawnAndDespawn();
+    void updateTimers(const float delta);
+    void watchArrivals(const float delta);
+    void scheduleGarage(Garage *garage, const TimerKind kind, const double due);
+
+    //length of a tick of the timer wheel
+    static const double TIMER_RESOLUTION;
+
+    TimerWheel timers;
+    std::vector<int> firedTimers;
+
+    std::vector<CrossLights*> localSignals;
+
+    //garage despawning vehicles from every lane, -1 for the other lanes
+    std::vector<int> laneGarage;
+
+    //garages to spawn or despawn at the beginning of the next tick, and the ones
+    //waiting for their exit to clear - the only ones visited every tick
+    std::vector<Garage*> readyGarages;
+    std::vector<Garage*> exitWatch;
+
+    void exchangeTails();
+    void exchangeVehicles();
+    void receiveVehicle(Message &message);
+
+    //intersections in one region, when the network is big enough
+    static const int REGION_CROSSES = 64;
+
+    VehicleStore vehicles;
+    VehiclePool pool;
+
+    //threads sharing the regions in every phase of a tick, none for a serial update
+    WorkStealingPool *workers;
+
+    //processes sharing the regions of a distributed simulation, none when it runs
+    //in one process; this process updates only localRegions and localSpots
+    Cluster *cluster;
+    std::vector<int> regionNode;
+    std::vector<int> laneRegion;
+    std::vector<int> localRegions;
+    std::vector<Garage*> localSpots;
+
+    //for every other node - lanes of this one entered from its intersections, whose
+    //tails are sent to it, and lanes of its own entered from here, received from it
+    std::vector<std::vector<int> > tailsOut;
+    std::vector<std::vector<int> > tailsIn;
+    std::vector<bool> laneEntered;
+
+    SymbolTable symbols;
+    double time;
+
+    uint64_t seed;
+    uint32_t streamsCounter[RandomStream::STREAM_KINDS];
+};
+
+#endif // SIMULATION_H
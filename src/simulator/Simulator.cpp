@@ -11,19 +11,31 @@
 #include"Simulator.h"
 using namespace std;
 
-Simulator &Simulator::getInstance()
+void Simulator::run(const bool headless, const bool turbo)
 {
-    static Simulator instanceSimulator;
+    reserveObjects();
 
-    return instanceSimulator;
-}
+    cout << "Initializing simulator...  ";
 
-void Simulator::run()
-{
-    objects.reserve(maxNumberOfObjects);
+    if (headless)
+        engine = new EngineCoreHeadless(this);
+    else
+        engine = new EngineCore(this);
+
+    engine->setTurbo(turbo);
+
+    //the window draws the intersections from the first frame, before the first step
+    prepareNetwork();
+
+    cout << "Success" << endl;
 
-    cout << "Simulator is running" << endl;
-    EngineCore::run();
+    cout << "Simulator is running" << (headless ? " (headless)" : "") << endl;
+    engine->run();
+
+    delete engine;
+    engine = nullptr;
+
+    cleanSimulation();
 }
 
 void Simulator::redraw()
@@ -39,26 +51,65 @@ void Simulator::redraw()
 
     pushMatrix();
 
+    frames.update();
+    const FrameSnapshot &frame = frames.getReadBuffer();
+
+    for (const auto &lights : frame.lights)
+    {
+        lights.lights->showState(lights.state);
+    }
+
+    //roads, intersections and garages don't change while the simulation runs
     for (const auto &object : objects)
     {
         object->drawObject();
     }
 
+    renderer.drawVehicles(frame);
+
     popMatrix();
 }
 
-Simulator::Simulator() : maxNumberOfObjects(0), CAMERA_VELOCITY(3)
+void Simulator::publishFrame()
 {
-    cout << "Initializing simulator...  ";
+    FrameSnapshot &frame = frames.getWriteBuffer();
+    VehicleStore &vehicles = getVehicleStore();
 
-    init();
+    frame.time = getTime();
+    frame.vehicles.resize(vehicles.size());
+    frame.lights.clear();
+
+    vehicles.updateLanePositions();
+
+    int n = 0;
+    for (int i = 0; i < vehicles.capacity(); i++)
+    {
+        if (vehicles.owner[i] != nullptr) vehicles.owner[i]->fillSnapshot(frame.vehicles[n++]);
+    }
+
+    for (const auto &region : regions)
+    {
+        for (const auto &lights : region.signals)
+        {
+            LightsSnapshot snapshot;
+            snapshot.lights = lights;
+            snapshot.state = lights->getState();
+
+            frame.lights.push_back(snapshot);
+        }
+    }
+
+    frames.publish();
+}
+
+Simulator::Simulator(const unsigned int seed) : Simulation(seed), CAMERA_VELOCITY(3)
+{
+    engine = nullptr;
 
     cameraPos = Vec3(-5.5, 2.5, -7.84);
     cameraRot = Vec3(-215, 13.2, 0);
 
     cameraDirection = 0;
-
-    cout << "Success" << endl;
 }
 
 void Simulator::keyHeld(char k)
@@ -89,8 +140,7 @@ void Simulator::keyPressed(char k)
     if (k == 27)
     {
         cout << "Stopping simulator" << endl;
-        cleanSimulation();
-        breakMainLoop();
+        engine->breakMainLoop();
         return;
     }
 
@@ -98,14 +148,12 @@ void Simulator::keyPressed(char k)
 
     switch (k)
     {
-        case 'y': updatesPerFrame++;    break;
-        case 't': updatesPerFrame--;    break;
-        case 'h': timeScale += 0.1;     break;
-        case 'g': timeScale -= 0.1;     break;
+        case 'y': engine->changeUpdatesPerFrame(1);     break;
+        case 't': engine->changeUpdatesPerFrame(-1);    break;
+        case 'h': engine->changeTimeScale(0.1);         break;
+        case 'g': engine->changeTimeScale(-0.1);        break;
+        case 'u': engine->setTurbo(!engine->isTurbo()); break;
     }
-
-    updatesPerFrame = max(MIN_UPDATES_PER_FRAME, min(updatesPerFrame, MAX_UPDATES_PER_FRAME));
-    timeScale = max(MIN_TIME_SCALE, min(timeScale, MAX_TIME_SCALE));
 }
 
 void Simulator::cameraMove(const float delta)
@@ -172,60 +220,5 @@ void Simulator::singleUpdate(const float delta)
 
 void Simulator::update(const float delta)
 {
-    for (auto &spot : spots)
-    {
-        if (spot->checkReadyToSpot())
-        {
-            registerObject(spot->spotVeh());
-        }
-        if (spot->checkReadyToDelete())
-        {
-            destroyObject(spot->deleteVeh());
-        }
-    }
-
-    for (auto &object : objects)
-    {
-        object->updateObject(delta);
-    }
-}
-
-void Simulator::registerObject(GameObject *go)
-{
-    objects.push_back(go);
-}
-
-void Simulator::destroyObject(GameObject *go)
-{
-     auto objectToRemove = find_if(objects.begin(), objects.end(), [&go] (GameObject *item) {return item == go;});
-     iter_swap(objectToRemove, objects.end() - 1);
-     objects.pop_back();
-}
-
-void Simulator::cleanSimulation()
-{
-    maxNumberOfObjects = 0;
-
-    while (objects.size() > 0)
-        destroyObject(objects.back());
-}
-
-GameObject* Simulator::findObjectByName(const string objectName) const
-{
-    auto foundObject = find_if(objects.begin(), objects.end(), [&objectName] (GameObject *item) {return item->id.compare(objectName) == 0;} );
-
-    if (foundObject != objects.end()) return *foundObject;
-    return nullptr;
-}
-
-void Simulator::loadedNewObject(GameObject *newGameObject)
-{
-    objects.push_back(newGameObject);
-    maxNumberOfObjects++;
-}
-
-void Simulator::loadedNewFactory(Garage *newFactory)
-{
-    spots.push_back(newFactory);
-    maxNumberOfObjects += newFactory->maxVehicles;
+    step(delta);
 }
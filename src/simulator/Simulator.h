@@ -21,42 +21,34 @@
 
 #include "EngineCore/EngineCore.h"
 #include "EngineCore/Graphics.h"
-#include "ObjectsLoader.h"
+#include "EngineCore/TripleBuffer.h"
+#include "Simulation.h"
+#include "FrameSnapshot.h"
 
-class GameObject;
+//Interactive front-end of a simulation - camera, keyboard and drawing
 
-class Simulator : private EngineCore, private Graphics, public ObjectsLoader
+class Simulator : private EngineApp, private Graphics, public Simulation
 {
-    friend GameObject;
-
 public:
-    static Simulator &getInstance();
+    Simulator(const unsigned int seed = 1);
 
     Vec3 cameraPos;
     Vec3 cameraRot;
 
-    void run();
-
-protected:
-    GameObject* findObjectByName(const std::string objectName) const;
-    void loadedNewObject(GameObject *newGameObject);
-    void loadedNewFactory(Garage *newFactory);
+    void run(const bool headless = false, const bool turbo = false);
 
 private:
-    Simulator();
-
-    void registerObject(GameObject *go);
-    void destroyObject(GameObject *go);
+    EngineCoreBase *engine;
 
-    void cleanSimulation();
-
-    std::vector<GameObject*> objects;
-    std::vector<Garage*> spots;
+    //frames go from the simulation thread to the window thread
+    TripleBuffer<FrameSnapshot> frames;
+    FrameRenderer renderer;
 
     void keyHeld(char k);
     void keyPressed(char k);
     void update(const float delta);
     void singleUpdate(const float delta);
+    void publishFrame();
     void redraw();
     void mouseMove(const int dx, const int dy);
 
@@ -70,8 +62,6 @@ private:
         DOWN
     };
 
-    int maxNumberOfObjects;
-
     unsigned int cameraDirection;
     float cameraVelocity;
 
@@ -0,0 +1,46 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: SlotRing.cpp
+
+
+#include "SlotRing.h"
+using namespace std;
+
+SlotRing::SlotRing()
+{
+    head = 0;
+    count = 0;
+}
+
+void SlotRing::push(const int slot)
+{
+    if (count == (int)buffer.size()) grow();
+
+    buffer[(head + count) & (buffer.size() - 1)] = slot;
+    count++;
+}
+
+void SlotRing::pop()
+{
+    head = (head + 1) & (buffer.size() - 1);
+    count--;
+}
+
+void SlotRing::grow()
+{
+    vector<int> bigger(buffer.size() > 0 ? buffer.size() * 2 : 8);
+
+    for (int i = 0; i < count; i++)
+    {
+        bigger[i] = (*this)[i];
+    }
+
+    buffer.swap(bigger);
+    head = 0;
+}
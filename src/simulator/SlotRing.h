@@ -0,0 +1,45 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: SlotRing.h
+
+
+#ifndef SLOTRING_H
+#define SLOTRING_H
+
+#include <vector>
+
+//Order preserving FIFO of vehicle slots in one contiguous ring buffer. Capacity is
+//a power of two and only ever grows, so pushing and popping never allocate once
+//the ring has reached its working size.
+
+class SlotRing
+{
+public:
+    SlotRing();
+
+    void push(const int slot);
+    void pop();
+
+    //accessors are inline, they are used in the innermost loop of the car following
+    int front() const { return buffer[head]; }
+    int back() const { return buffer[(head + count - 1) & (buffer.size() - 1)]; }
+    int operator [] (const int i) const { return buffer[(head + i) & (buffer.size() - 1)]; }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    std::vector<int> buffer;
+    int head;
+    int count;
+
+    void grow();
+};
+
+#endif // SLOTRING_H
@@ -0,0 +1,52 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: SymbolTable.cpp
+
+
+#include "SymbolTable.h"
+#include "EngineCore/ExceptionClass.h"
+using namespace std;
+
+int SymbolTable::intern(const string &name)
+{
+    auto found = symbols.find(name);
+    if (found != symbols.end()) return found->second;
+
+    int symbol = names.size();
+    symbols[name] = symbol;
+    names.push_back(name);
+
+    return symbol;
+}
+
+int SymbolTable::find(const string &name) const
+{
+    auto found = symbols.find(name);
+    if (found != symbols.end()) return found->second;
+
+    return NONE;
+}
+
+const string& SymbolTable::getName(const int symbol) const
+{
+    if (symbol < 0 || symbol >= (int)names.size()) throw ExceptionClass("unknown symbol");
+
+    return names[symbol];
+}
+
+int SymbolTable::size() const
+{
+    return names.size();
+}
+
+void SymbolTable::clear()
+{
+    symbols.clear();
+    names.clear();
+}
@@ -0,0 +1,39 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: SymbolTable.h
+
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+//Names of the loaded objects, interned once - every name gets a dense integer ID
+//in order of interning, which can be used to index per-object tables
+
+class SymbolTable
+{
+public:
+    static const int NONE = -1;
+
+    int intern(const std::string &name);
+    int find(const std::string &name) const;
+    const std::string& getName(const int symbol) const;
+
+    int size() const;
+    void clear();
+
+private:
+    std::unordered_map<std::string, int> symbols;
+    std::vector<std::string> names;
+};
+
+#endif // SYMBOLTABLE_H
@@ -11,51 +11,55 @@
 
 #include "Vehicle.h"
 #include "Road.h"
+#include "Simulation.h"
 
 class Driveable;
 
-const Vec3 Vehicle::blinkerColor = Vec3(1, 0.647, 0);
-
-Vehicle::Vehicle(Driveable *spawnRoad)
+Vehicle::Vehicle(Simulation *sim, Driveable *spawnRoad, const RandomStream &stream, const int storeSlot) : GameObject(sim)
 {
-    initRandValues();
+    random = stream;
+
+    store = &sim->getVehicleStore();
+    slot = storeSlot;
 
-    velocity = 0;
-    specs.vehicleLength = 0.2;
-    xPos = 0;
+    initRandValues();
 
-    isBraking = false;
+    store->velocity[slot] = 0;
+    store->vehicleLength[slot] = 0.2;
+    store->xPos[slot] = 0;
+    store->dstToCross[slot] = 1000;
 
-    dstToCross = 1000;
     direction = true;
+    approach = 0;
     desiredTurn = 0;
+    cornerPath = nullptr;
 
-    blinker.init();
+    origin = SymbolTable::NONE;
+    number = 0;
 
-    initPointers(spawnRoad);
+    VehicleStore::Blinker &blinker = store->blinker[slot];
+    blinker.which = 0;
+    blinker.startTime = 0;
+    blinker.duration = randFloat(0.45,0.55);
 
-    rot = Vec3(0, curRoad->getDirection().angleXZ(), 0);
+    initPointers(spawnRoad);
 
-    color = Colors::getRandomColor();
+    Vec3 color = Colors::getColor(randInt(0, Colors::AMOUNT - 1));
     color *= 0.70f;
+    store->color[slot] = color;
 }
 
 void Vehicle::initRandValues()
 {
-    specs.maxV = randFloat(1, 1.5);
-    specs.minV = randFloat(0.02, 0.08);
-    specs.cornerVelocity = 1;
-    specs.stopTime = randFloat(0.5, 0.8);
-    specs.acceleration = randFloat(0.1,0.2);
-    specs.remainDst = randFloat(0.06, 0.08);
-}
-
-void Vehicle::Blinker::init()
-{
-    which = 0;
-    time = 0;
-    duration  = randFloat(0.45,0.55);
-    isLighting = true;
+    float r[5];
+    random.fill(r, 5);
+
+    store->maxV[slot] = 1 + 0.5 * r[0];
+    store->minV[slot] = 0.02 + 0.06 * r[1];
+    store->cornerVelocity[slot] = 1;
+    store->stopTime[slot] = 0.5 + 0.3 * r[2];
+    store->acceleration[slot] = 0.1 + 0.1 * r[3];
+    store->remainDst[slot] = 0.06 + 0.02 * r[4];
 }
 
 void Vehicle::initPointers(Driveable *spawnRoad)
@@ -64,71 +68,43 @@ void Vehicle::initPointers(Driveable *spawnRoad)
     curCross = nullptr;
     nextRoad = nullptr;
 
-    backVeh = nullptr;
-
     allowedToCross = false;
-    crossState.isChanging = false;
-    crossState.didReachCross = false;
     crossState.isLeavingRoad = false;
 
-    frontVeh = NULL;
-    isFirstVeh = true;
-
-    if (curRoad->vehiclesBeg.size() > 0 /*&& !curRoad->vehiclesBeg.back()->isChanging*/)
-    {
-        isFirstVeh = false;
-        frontVeh = curRoad->vehiclesBeg.back();
-        frontVeh->backVeh = this;
-    }
+    store->lane[slot] = curRoad->getLaneIndex(true);
 }
 
-void Vehicle::update(const float delta)
-{
-    if (!crossState.isChanging && !crossState.didReachCross)
-    {
-        float prevVelocity = velocity;
-
-        xPos += velocity * delta;
+//Called only while the vehicle is flagged as being in a transition; driving along
+//a lane is done for all vehicles at once by VehicleStore::updateDriving
 
-        setVelocity();
-        checkVelocity(delta, prevVelocity);
-        setNewPos();
+void Vehicle::updateTransition(const float delta)
+{
+    float &xPos = store->xPos[slot];
+    const float cornerVelocity = store->cornerVelocity[slot];
 
-        if (curRoad->getLength() - xPos < 2.4 && curCross == nullptr)
-        {
-            registerToCross();
-        }
+    if (store->state[slot] == VehicleStore::DRIVING && curCross == nullptr && store->dstToCross[slot] < VehicleStore::REGISTER_DST)
+    {
+        registerToCross();
     }
 
-    if (!crossState.isLeavingRoad && curCross != nullptr && nextRoad != nullptr && allowedToCross/* && nextRoad->freeSpace(direction) > vehicleLength + remainDst*/)
+    if (!crossState.isLeavingRoad && curCross != nullptr && nextRoad != nullptr && allowedToCross)
     {
         tryBeAllowedToEnterCross();
     }
 
-    if (crossState.isChanging)
+    if (store->state[slot] == VehicleStore::CHANGING)
     {
-        xPos += specs.cornerVelocity * delta;
+        xPos += cornerVelocity * delta;
 
-        float s = xPos / curRoad->getLength();
-
-        if (direction)
-        {
-            pos = Vec3::lerp(curRoad->getBegJointWidth(direction), curRoad->getEndJointWidth(direction), s);
-        }
-        else
-        {
-            pos = Vec3::lerp(curRoad->getEndJointWidth(direction), curRoad->getBegJointWidth(direction), s);
-        }
-
-        if(s > 1)
+        if (xPos > curRoad->getLength())
         {
             leaveRoad();
         }
     }
 
-    if (crossState.didReachCross)
+    if (store->state[slot] == VehicleStore::CORNERING)
     {
-        xPos += specs.cornerVelocity * delta;
+        xPos += cornerVelocity * delta;
 
         setCornerPosition();
 
@@ -137,91 +113,29 @@ void Vehicle::update(const float delta)
             enterNewRoad();
         }
     }
-
-    blinker.updateBlinkers(delta);
 }
 
-void Vehicle::setVelocity()
+std::string Vehicle::getName() const
 {
-    float posDiff = getDst() - specs.vehicleLength / 2.0 - specs.remainDst;
-    float newDst = velocity * specs.stopTime - specs.acceleration * specs.stopTime * specs.stopTime / 2.0;
-
-    if (newDst > posDiff)
-    {
-        velocity = posDiff - specs.acceleration * specs.stopTime * specs.stopTime / 2.0;
-        velocity /= specs.stopTime;
-    }
-    else if (posDiff > newDst)
-    {
-        velocity = posDiff - specs.acceleration * specs.stopTime * specs.stopTime / 2.0;
-        velocity /= specs.stopTime;
-    }
-}
-
-void Vehicle::checkVelocity(const float delta, float prevVelocity)
-{
-    float braking = (velocity - prevVelocity) / delta;
-
-    if (braking < -0.3)
-    {
-        isBraking = true;
-    }
-    else
-    {
-        isBraking = false;
-    }
-
-    if (velocity < specs.minV)
-    {
-        velocity = 0;
-        isBraking = true;
-    }
-
-    if (velocity > specs.maxV)
-    {
-        velocity = specs.maxV;
-    }
+    std::ostringstream ss;
+    ss << getKindName() << "_" << simulation->getSymbols().getName(origin) << "_" << number;
+    return ss.str();
 }
 
 float Vehicle::getXPos() const
 {
-    return xPos;
+    return store->xPos[slot];
 }
 
 float Vehicle::getDstToCross() const
 {
-    return dstToCross;
-}
-
-void Vehicle::setNewPos()
-{
-
-    if(xPos > curRoad->getLength())
-    {
-        xPos = curRoad->getLength();
-    }
-
-    float s = xPos / curRoad->getLength();
-
-    if (s>1)
-    {
-        s=1;
-    }
-
-    if (direction)
-    {
-        pos = Vec3::lerp(curRoad->getBegJointWidth(direction), curRoad->getEndJointWidth(direction), s);
-    }
-    else
-    {
-        pos = Vec3::lerp(curRoad->getEndJointWidth(direction), curRoad->getBegJointWidth(direction), s);
-    }
-
-    dstToCross = curRoad->getLength() - xPos;
+    return store->dstToCross[slot];
 }
 
 void Vehicle::registerToCross()
 {
+    VehicleStore::Blinker &blinker = store->blinker[slot];
+
     allowedToCross = false;
 
     if(direction)
@@ -241,6 +155,8 @@ void Vehicle::registerToCross()
         {
             if (curCross->streets[i].street == curRoad)
             {
+                approach = i;
+
                 desiredTurn = randInt(0, curCross->streets.size()-1);
                 if (desiredTurn == (int)i) desiredTurn = (desiredTurn+1) % curCross->streets.size();
 
@@ -257,38 +173,47 @@ void Vehicle::registerToCross()
                 blinker.which = rotateDirection(crossState.begRot, crossState.endRot);
                 if (curCross->streets.size() == 2) blinker.which = 0;
 
-                blinker.time = 0;
-                blinker.isLighting = true;
+                blinker.startTime = simulation->getTime();
 
-                curCross->streets[i].vehicles.push_back(this);
+                curCross->addWaitingVehicle(i, this);
 
                 break;
             }
         }
     }
+
+    store->setWaiting(slot);
+}
+
+//Called by the intersection
+void Vehicle::allowToCross()
+{
+    allowedToCross = true;
+    store->wake(slot);
 }
 
 void Vehicle::tryBeAllowedToEnterCross()
 {
+    const float space = store->vehicleLength[slot] + store->remainDst[slot];
+
     for (auto &street : curCross->streets)
     {
         if (street.street == nextRoad)
         {
-            if (nextRoad->freeSpace(street.direction) > specs.vehicleLength + specs.remainDst)
+            const int nextLane = nextRoad->getLaneIndex(street.direction);
+
+            if (nextRoad->freeSpace(street.direction) > space)
             {
                 crossState.isLeavingRoad = true;
 
-                if (street.direction)
-                {
-                    nextRoad->reservedSpaceBeg += specs.vehicleLength + specs.remainDst;
-                }
-                else
-                {
-                    nextRoad->reservedSpaceEnd += specs.vehicleLength + specs.remainDst;
-                }
-
-                crossState.isChanging = true;
-                crossState.didReachCross = false;
+                store->reserveSpace(nextLane, space);
+
+                store->state[slot] = VehicleStore::CHANGING;
+                store->wake(slot);
+            }
+            else
+            {
+                store->waitForSpace(slot, nextLane);
             }
 
             break;
@@ -298,24 +223,10 @@ void Vehicle::tryBeAllowedToEnterCross()
 
 void Vehicle::leaveRoad()
 {
-    xPos = 0;
-    crossState.didReachCross = true;
-    crossState.isChanging = false;
+    store->xPos[slot] = 0;
+    store->state[slot] = VehicleStore::CORNERING;
 
-    if (curCross->streets[desiredTurn].direction)
-    {
-        nextRoadJoint = nextRoad->getBegJointWidth(curCross->streets[desiredTurn].direction);
-    }
-    else
-    {
-        nextRoadJoint = nextRoad->getEndJointWidth(curCross->streets[desiredTurn].direction);
-    }
-
-    if(backVeh != nullptr)
-    {
-        backVeh->isFirstVeh = true;
-        backVeh->frontVeh = nullptr;
-    }
+    cornerPath = &curCross->getPath(approach, desiredTurn);
 
     crossState.begRot = curRoad->direction.angleXZ();
     crossState.endRot = nextRoad->direction.angleXZ();
@@ -326,247 +237,199 @@ void Vehicle::leaveRoad()
 
 void Vehicle::setCornerPosition()
 {
-    float tempLength;
-    float s;
-
-    if (direction)
-    {
-        tempLength = Vec3::length(curRoad->getEndJointWidth(direction) - nextRoadJoint);
-        s = xPos / tempLength;
-
-        if(s>1)s=1;
-
-        pos  = Vec3::lerp(curRoad->getEndJointWidth(direction), nextRoadJoint, s);
-    }
-    else
-    {
-        tempLength = Vec3::length(curRoad->getBegJointWidth(direction) - nextRoadJoint);
-        s = xPos / tempLength;
+    float s = store->xPos[slot] / cornerPath->getLength();
 
-        if(s>1)s=1;
+    if(s>1)s=1;
 
-        pos  = Vec3::lerp(curRoad->getBegJointWidth(direction), nextRoadJoint, s);
-    }
-
-    rot = Vec3(0, lerpAngle(crossState.begRot, crossState.endRot, s), 0);
     crossState.crossProgress = s;
 }
 
 void Vehicle::enterNewRoad()
 {
-    blinker.which = 0;
-
-    if(backVeh != nullptr)
-    {
-        backVeh->isFirstVeh = true;
-        backVeh->frontVeh = nullptr;
-    }
+    const float space = store->vehicleLength[slot] + store->remainDst[slot];
 
-    if (direction)
-    {
-        curRoad->vehiclesBeg.pop();
-    }
-    else
-    {
-        curRoad->vehiclesEnd.pop();
-    }
+    store->blinker[slot].which = 0;
 
-    xPos = 0;
-    isBraking = false;
+    store->xPos[slot] = 0;
+    store->velocity[slot] = store->cornerVelocity[slot];
+    store->state[slot] = VehicleStore::DRIVING;
+    store->flags[slot] = 0;
 
     allowedToCross = false;
 
-    crossState.isChanging = false;
-    crossState.didReachCross = false;
     crossState.isLeavingRoad = false;
 
-    velocity = specs.cornerVelocity;
-
     curRoad = curCross->streets[desiredTurn].street;
 
     direction = curCross->streets[desiredTurn].direction;
 
-    //dstToCross = curCross->getLength();
-
-    if (direction)
-    {
-        nextRoad->reservedSpaceBeg -= specs.vehicleLength + specs.remainDst;
-    }
-    else
-    {
-        nextRoad->reservedSpaceEnd -= specs.vehicleLength + specs.remainDst;
-    }
-
     curCross->allowedVeh--;
     desiredTurn = 0;
 
-    backVeh = nullptr;
-
-    frontVeh = nullptr;
-    isFirstVeh = true;
-
-    if (direction)
-    {
-        if (curRoad->vehiclesBeg.size() > 0)
-        {
-            isFirstVeh = false;
-            frontVeh = curRoad->vehiclesBeg.back();
-            frontVeh->backVeh = this;
-        }
-    }
-    else
-    {
-        if (curRoad->vehiclesEnd.size() > 0)
-        {
-            isFirstVeh = false;
-            frontVeh = curRoad->vehiclesEnd.back();
-            frontVeh->backVeh = this;
-        }
-    }
-
-    if (direction)
-    {
-        curRoad->vehiclesBeg.push(this);
-    }
-    else
-    {
-        curRoad->vehiclesEnd.push(this);
-    }
+    //the lanes may belong to other regions, the vehicle is handed over at the end of the tick
+    const int newLane = curRoad->getLaneIndex(direction);
+    store->moveVehicle(store->lane[slot], newLane, slot, space);
+    store->lane[slot] = newLane;
 
     nextRoad = nullptr;
     curCross = nullptr;
+    cornerPath = nullptr;
 }
 
-void Vehicle::Blinker::updateBlinkers(const float delta)
+Driveable* Vehicle::getRoad() const
 {
-    time += delta;
-
-    if (time > duration)
-    {
-        time = 0;
-        isLighting = !isLighting;
-    }
+    return curRoad;
 }
 
-float Vehicle::getDst() const
+//Everything but the lane and the drawing state, which the receiver sets itself
+
+void Vehicle::saveState(Message &message) const
 {
-    if (frontVeh != nullptr)
-        return frontVeh->xPos - xPos - frontVeh->specs.vehicleLength/2.0;
+    message.put(random);
+
+    message.put(store->xPos[slot]);
+    message.put(store->velocity[slot]);
+    message.put(store->dstToCross[slot]);
+    message.put(store->maxV[slot]);
+    message.put(store->minV[slot]);
+    message.put(store->cornerVelocity[slot]);
+    message.put(store->stopTime[slot]);
+    message.put(store->acceleration[slot]);
+    message.put(store->vehicleLength[slot]);
+    message.put(store->remainDst[slot]);
+    message.put(store->state[slot]);
+    message.put(store->flags[slot]);
+    message.put(store->color[slot]);
+    message.put(store->busAngle[slot]);
+    message.put(store->blinker[slot]);
+
+    message.put(crossState);
+    message.put(origin);
+    message.put(number);
+    message.put(direction);
+    message.put(approach);
+    message.put(desiredTurn);
+}
 
-    return curRoad->getLength() - xPos;
+void Vehicle::loadState(Message &message, const int toLane)
+{
+    random = message.get<RandomStream>();
+
+    store->xPos[slot] = message.get<float>();
+    store->velocity[slot] = message.get<float>();
+    store->dstToCross[slot] = message.get<float>();
+    store->maxV[slot] = message.get<float>();
+    store->minV[slot] = message.get<float>();
+    store->cornerVelocity[slot] = message.get<float>();
+    store->stopTime[slot] = message.get<float>();
+    store->acceleration[slot] = message.get<float>();
+    store->vehicleLength[slot] = message.get<float>();
+    store->remainDst[slot] = message.get<float>();
+    store->state[slot] = message.get<unsigned char>();
+    store->flags[slot] = message.get<unsigned char>();
+    store->color[slot] = message.get<Vec3>();
+    store->busAngle[slot] = message.get<float>();
+    store->blinker[slot] = message.get<VehicleStore::Blinker>();
+
+    crossState = message.get<decltype(crossState)>();
+    origin = message.get<int>();
+    number = message.get<int>();
+    direction = message.get<bool>();
+    approach = message.get<int>();
+    desiredTurn = message.get<int>();
+
+    store->lane[slot] = toLane;
+    store->enterLane(toLane, slot);
 }
 
 bool Vehicle::isEnoughSpace() const
 {
     if (nextRoad == nullptr || curCross == nullptr || desiredTurn >= (int)curCross->streets.size()) return false;
 
-    return nextRoad->freeSpace(curCross->streets[desiredTurn].direction) > specs.vehicleLength + specs.remainDst;
+    return nextRoad->freeSpace(curCross->streets[desiredTurn].direction) > store->vehicleLength[slot] + store->remainDst[slot];
 }
 
-Car::Car(Driveable *spawnRoad) : Vehicle(spawnRoad)
+bool Vehicle::isBlinkerLighting() const
 {
-    velocity = randFloat(2,5);
+    return store->blinker[slot].isLighting(simulation->getTime());
 }
 
-void Car::update(float delta)
+//Position and heading are needed only for drawing, so they are derived here from
+//the progress through the intersection instead of being updated every tick; the
+//vehicles along lanes are placed by VehicleStore::updateLanePositions
+
+void Vehicle::setRenderState()
 {
-    Vehicle::update(delta);
+    const float s = crossState.crossProgress;
+
+    store->position[slot] = cornerPath->getPoint(s);
+    store->rotation[slot] = Vec3(0, cornerPath->getHeading(s), 0);
 }
 
-void Car::draw()
+void Vehicle::fillSnapshot(VehicleSnapshot &snapshot)
 {
-    translate(0, -0.02, 0);
+    if (store->state[slot] == VehicleStore::CORNERING) setRenderState();
 
-    if (blinker.which < 0 && blinker.isLighting)
-    {
-        pushMatrix();
-        translate(0,0.05,-0.038);
-        setColor(blinkerColor);
-        drawCube(0.22,0.02,0.01);
-        popMatrix();
-    }
-    if (blinker.which > 0 && blinker.isLighting)
-    {
-        pushMatrix();
-        translate(0,0.05,0.038);
-        setColor(blinkerColor);
-        drawCube(0.22,0.02,0.01);
-        popMatrix();
-    }
+    const VehicleStore::Blinker &blinker = store->blinker[slot];
+
+    snapshot.position = store->position[slot];
+    snapshot.heading = store->rotation[slot].y;
+    snapshot.busAngle = store->busAngle[slot];
+    snapshot.color = store->color[slot];
+    snapshot.kind = store->kind[slot];
+    snapshot.blinker = isBlinkerLighting() ? blinker.which : 0;
+    snapshot.braking = (store->flags[slot] & VehicleStore::BRAKING) != 0;
+}
 
-    if (isBraking)
+template <class T>
+void VehicleKind<T>::updateBatch(VehicleStore &store, const std::vector<int> &slots, const float delta)
+{
+    for (unsigned int k = 0; k < slots.size(); k++)
     {
-        setColor(1,0,0);
-
-        pushMatrix();
-        translate(-0.05,0.08,0);
-        drawCube(0.07,0.003,0.04);
-        popMatrix();
-
-        pushMatrix();
-        translate(-0.05,0.05,0.033);
-        drawCube(0.12,0.01,0.01);
-        popMatrix();
-
-        pushMatrix();
-        translate(-0.05,0.05,-0.033);
-        drawCube(0.12,0.01,0.01);
-        popMatrix();
+        const int i = slots[k];
+
+        if ((store.flags[i] & VehicleStore::TRANSITION) && !store.isBlocked(i))
+        {
+            static_cast<T*>(store.owner[i])->updateTransition(delta);
+        }
     }
-    setColor(color);
+}
 
-    pushMatrix();
-    translate(0,0.05,0);
-    drawCube(0.2,0.05,0.1);
-    drawRoof();
+template class VehicleKind<Car>;
+template class VehicleKind<Bus>;
 
-    popMatrix();
+Car::Car(Simulation *sim, Driveable *spawnRoad, const RandomStream &stream, const int storeSlot) : VehicleKind<Car>(sim, spawnRoad, stream, storeSlot)
+{
+    store->velocity[slot] = randFloat(2,5);
 }
 
-void Car::drawRoof()
+const char* Car::getKindName() const
 {
-    Vec3 a1(0,0,-0.05);
-    Vec3 a2(0.025,0.05,-0.0375);
-    Vec3 a3(0.075,0.05,-0.0375);
-    Vec3 a4(0.1125,0,-0.05);
-    Vec3 a5(0,0,0.05);
-    Vec3 a6(0.025,0.05,0.0375);
-    Vec3 a7(0.075,0.05,0.0375);
-    Vec3 a8(0.1125,0,0.05);
-
-    pushMatrix();
-    translate(-0.075, 0.025, 0);
-    beginDraw(QUADS);
-
-    drawQuad(a2,a6,a7,a3);
-
-    setColor(0,1,1);
-
-    drawQuad(a1,a2,a3,a4);
-    drawQuad(a1,a5,a6,a2);
-    drawQuad(a5,a8,a7,a6);
-    drawQuad(a8,a4,a3,a7);
-
-    endDraw();
-    popMatrix();
+    return "CAR";
 }
 
-Bus::Bus(Driveable *spawnRoad) : Vehicle(spawnRoad)
+Bus::Bus(Simulation *sim, Driveable *spawnRoad, const RandomStream &stream, const int storeSlot) : VehicleKind<Bus>(sim, spawnRoad, stream, storeSlot)
 {
-    specs.maxV = randFloat(0.8, 1.1);
-    velocity = randFloat(2,5);
+    store->maxV[slot] = randFloat(0.8, 1.1);
+    store->velocity[slot] = randFloat(2,5);
 
-    specs.vehicleLength = 0.66;
-    specs.remainDst = randFloat(0.14, 0.15);
+    store->vehicleLength[slot] = 0.66;
+    store->remainDst[slot] = randFloat(0.14, 0.15);
 
-    color = Vec3(0.7, 0.7, 0);
+    store->color[slot] = Vec3(0.7, 0.7, 0);
 }
 
-void Bus::update(const float delta)
+const char* Bus::getKindName() const
 {
-    Vehicle::update(delta);
+    return "BUS";
+}
 
-    if (crossState.didReachCross)
+//Articulation of the bus while it turns through an intersection
+void Bus::articulate()
+{
+    float &busAngle = store->busAngle[slot];
+
+    if (store->state[slot] == VehicleStore::CORNERING)
     {
         float s = crossState.crossProgress * 2.0 - 1.0;
         s = 1 - abs(s);
@@ -580,74 +443,3 @@ void Bus::update(const float delta)
         busAngle = 0;
     }
 }
-
-void Bus::draw()
-{
-    pushMatrix();
-
-    translate(0,0.07,0);
-
-    setColor(color);
-    pushMatrix();
-    rotateY(-busAngle / 1.3);
-    translate(-0.2,0,0);
-    drawCube(0.3,0.13,0.135);
-    setColor(0,0.8,0.8);
-    translate(-0.02,0.02,0);
-    drawCube(0.25,0.07,0.14);
-    popMatrix();
-
-    setColor(color);
-    pushMatrix();
-
-    rotateY(busAngle / 4);
-    translate(0.2,0,0);
-    drawCube(0.3, 0.13, 0.135);
-    setColor(0,0.8,0.8);
-    translate(0.02,0.02,0);
-    drawCube(0.27,0.07,0.14);
-    popMatrix();
-
-    setColor(0.5,0.5,0);
-    drawCube(0.2,0.12,0.12);
-
-    pushMatrix();
-    if (blinker.which < 0 && blinker.isLighting)
-    {
-        setColor(blinkerColor);
-        translate(0, -0.031,-0.046);
-        drawCube(0.73,0.01,0.01);
-    }
-    if (blinker.which > 0 && blinker.isLighting)
-    {
-        setColor(blinkerColor);
-        translate(0, -0.031,0.046);
-        drawCube(0.73,0.01,0.01);
-    }
-    popMatrix();
-
-    if (isBraking)
-    {
-        pushMatrix();
-        setColor(1,0,0);
-        rotateY(-busAngle / 1.3);
-
-        pushMatrix();
-        translate(-0.3,0.05,0);
-        drawCube(0.12,0.003,0.06);
-        popMatrix();
-
-        pushMatrix();
-        translate(-0.3,-0.02,0.04);
-        drawCube(0.12,0.01,0.01);
-        popMatrix();
-
-        pushMatrix();
-        translate(-0.3,-0.02,-0.04);
-        drawCube(0.12,0.01,0.01);
-        popMatrix();
-        popMatrix();
-    }
-
-    popMatrix();
-}
@@ -15,47 +15,51 @@
 #include "GameObject.h"
 #include "Road.h"
 #include "EngineCore/Colors.h"
+#include "VehicleStore.h"
+#include "FrameSnapshot.h"
+#include "EngineCore/Cluster.h"
 
 class Driveable;
 class Cross;
 class Garage;
+class VehiclePool;
+class CurvePath;
 
 class Vehicle : public GameObject
 {
 public:
-    Vehicle(Driveable *spawnRoad);
+    Vehicle(Simulation *sim, Driveable *spawnRoad, const RandomStream &stream, const int storeSlot);
 
     float getXPos() const;
     float getDstToCross() const;
 
     virtual void initRandValues();
-    struct Adjustable
-    {
-        float maxV;
-        float minV;
-        float cornerVelocity;
-        float stopTime;
-        float acceleration;
-        float vehicleLength;
-        float remainDst;
-    } specs;
+
+    std::string getName() const;
+
+    void fillSnapshot(VehicleSnapshot &snapshot);
+
+    //state of a vehicle handed over to another process of a distributed simulation;
+    //the receiver creates the vehicle on the same road, loads the rest and enters
+    //it to its lane
+    void saveState(Message &message) const;
+    void loadState(Message &message, const int toLane);
+
+    Driveable* getRoad() const;
 
 protected:
     virtual ~Vehicle(){};
 
-    float velocity;
-    float xPos;
-    bool isBraking;
+    //kinematic state lives in the simulation's vehicle store, under this slot
+    VehicleStore *store;
+    int slot;
 
-    void update(const float delta);
+    void updateTransition(const float delta);
 
-    float getDst() const;
     bool isEnoughSpace() const;
 
     struct
     {
-        bool isChanging;
-        bool didReachCross;
         bool isLeavingRoad;
 
         float begRot;
@@ -63,78 +67,90 @@ protected:
         float crossProgress;
     } crossState;
 
-    struct Blinker
-    {
-        int which;
-        bool isLighting;
-
-    private:
-        float time;
-        float duration;
-
-        void init();
-        void updateBlinkers(const float delta);
+    //garage that spawned the vehicle and its number there, to build the name on demand
+    int origin;
+    int number;
 
-        friend Vehicle;
-    } blinker;
+    virtual const char* getKindName() const = 0;
 
-    Vec3 color;
-    static const Vec3 blinkerColor;
+    bool isBlinkerLighting() const;
 
 private:
     void initPointers(Driveable *spawnRoad);
 
-    void setVelocity();
-    void checkVelocity(const float delta, float prevVelocity);
-    void setNewPos();
     void registerToCross();
+    void allowToCross();
 
     void tryBeAllowedToEnterCross();
     void leaveRoad();
     void setCornerPosition();
     void enterNewRoad();
 
-    float dstToCross;
+    void setRenderState();
 
     bool direction;
 
+    int approach;
     int desiredTurn;
     Driveable *nextRoad;
     bool allowedToCross;
 
-    Vec3 nextRoadJoint;
+    //compiled path of the movement through the current intersection
+    const CurvePath *cornerPath;
 
     Driveable *curRoad;
     Cross *curCross;
-    Vehicle *frontVeh;
-    Vehicle *backVeh;
-    bool isFirstVeh;
 
     friend Garage;
     friend Cross;
+    friend VehiclePool;
+};
+
+//Compile-time dispatch of the per-kind parts of the update. The vehicles of every
+//kind are updated in a separate batch calling T::updateTransition directly, so a
+//kind pays only for the hooks it overrides (by hiding them).
+
+template <class T>
+class VehicleKind : public Vehicle
+{
+public:
+    static void updateBatch(VehicleStore &store, const std::vector<int> &slots, const float delta);
+
+    void updateTransition(const float delta)
+    {
+        Vehicle::updateTransition(delta);
+        static_cast<T*>(this)->articulate();
+    }
+
+protected:
+    VehicleKind(Simulation *sim, Driveable *spawnRoad, const RandomStream &stream, const int storeSlot) : Vehicle(sim, spawnRoad, stream, storeSlot) {}
+
+    void articulate() {}
 };
 
-class Car : public Vehicle
+class Car : public VehicleKind<Car>
 {
 public:
-    Car(Driveable *spawnRoad);
+    Car(Simulation *sim, Driveable *spawnRoad, const RandomStream &stream, const int storeSlot);
+
+    static const VehicleStore::Kind KIND = VehicleStore::CAR;
 
 private:
-    void update(const float delta);
-    void draw();
-    void drawRoof();
+    const char* getKindName() const;
 };
 
-class Bus : public Vehicle
+class Bus : public VehicleKind<Bus>
 {
 public:
-    Bus(Driveable *spawnRoad);
+    Bus(Simulation *sim, Driveable *spawnRoad, const RandomStream &stream, const int storeSlot);
+
+    static const VehicleStore::Kind KIND = VehicleStore::BUS;
 
 private:
-    float busAngle;
+    const char* getKindName() const;
+    void articulate();
 
-    void update(const float delta);
-    void draw();
+    friend VehicleKind<Bus>;
 };
 
 #endif // VEHICLE_H
@@ -0,0 +1,84 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: VehiclePool.cpp
+
+
+#include "VehiclePool.h"
+using namespace std;
+
+VehicleHandle::VehicleHandle()
+{
+    slot = -1;
+    generation = 0;
+}
+
+VehicleHandle::VehicleHandle(const int s, const uint32_t g)
+{
+    slot = s;
+    generation = g;
+}
+
+VehiclePool::VehiclePool(VehicleStore &vehicleStore) : store(vehicleStore)
+{
+
+}
+
+VehiclePool::~VehiclePool()
+{
+    destroyAll();
+
+    for (auto &chunk : chunks)
+    {
+        delete[] chunk;
+    }
+}
+
+void* VehiclePool::getBlock(const int slot)
+{
+    while (slot >= (int)chunks.size() * CHUNK_BLOCKS)
+    {
+        chunks.push_back(new Block[CHUNK_BLOCKS]);
+    }
+
+    return &chunks[slot / CHUNK_BLOCKS][slot % CHUNK_BLOCKS];
+}
+
+void VehiclePool::destroy(Vehicle *vehicle)
+{
+    int slot = vehicle->slot;
+
+    vehicle->~Vehicle();
+    store.release(slot);
+}
+
+void VehiclePool::destroyAll()
+{
+    for (int i = 0; i < store.capacity(); i++)
+    {
+        if (store.owner[i] != nullptr) destroy(store.owner[i]);
+    }
+}
+
+VehicleHandle VehiclePool::getHandle(const Vehicle *vehicle) const
+{
+    return VehicleHandle(vehicle->slot, store.generation[vehicle->slot]);
+}
+
+Vehicle* VehiclePool::get(const VehicleHandle handle) const
+{
+    if (handle.slot < 0 || handle.slot >= store.capacity()) return nullptr;
+    if (store.generation[handle.slot] != handle.generation) return nullptr;
+
+    return store.owner[handle.slot];
+}
+
+int VehiclePool::getChunksNumber() const
+{
+    return chunks.size();
+}
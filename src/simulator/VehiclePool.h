@@ -0,0 +1,79 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: VehiclePool.h
+
+
+#ifndef VEHICLEPOOL_H
+#define VEHICLEPOOL_H
+
+#include <new>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+#include "Vehicle.h"
+#include "VehicleStore.h"
+
+//Reference to a vehicle that may already be gone - resolves to nullptr once the
+//vehicle was despawned, even if its slot was reused in the meantime
+
+struct VehicleHandle
+{
+    int slot;
+    uint32_t generation;
+
+    VehicleHandle();
+    VehicleHandle(const int s, const uint32_t g);
+};
+
+//Slab allocator for the vehicles of one simulation. Memory block of a vehicle is
+//addressed by its store slot, blocks are allocated in chunks which are never freed
+//or moved until the pool is destroyed, so recycled spawns don't touch the heap.
+
+class VehiclePool
+{
+public:
+    VehiclePool(VehicleStore &vehicleStore);
+    ~VehiclePool();
+
+    template <class T>
+    T* create(Simulation *sim, Driveable *spawnRoad, const RandomStream &stream)
+    {
+        static_assert(sizeof(T) <= sizeof(Block), "vehicle type does not fit in a pool block");
+
+        int slot = store.allocate(T::KIND);
+        T *vehicle = new (getBlock(slot)) T(sim, spawnRoad, stream, slot);
+        store.owner[slot] = vehicle;
+
+        return vehicle;
+    }
+
+    void destroy(Vehicle *vehicle);
+    void destroyAll();
+
+    VehicleHandle getHandle(const Vehicle *vehicle) const;
+    Vehicle* get(const VehicleHandle handle) const;
+
+    int getChunksNumber() const;
+
+    static const int CHUNK_BLOCKS = 256;
+
+private:
+    VehiclePool(const VehiclePool&);
+    VehiclePool& operator = (const VehiclePool&);
+
+    typedef std::aligned_union<0, Car, Bus>::type Block;
+
+    VehicleStore &store;
+    std::vector<Block*> chunks;
+
+    void* getBlock(const int slot);
+};
+
+#endif // VEHICLEPOOL_H
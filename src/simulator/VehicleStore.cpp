@@ -0,0 +1,738 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: VehicleStore.cpp
+
+
+#include <cmath>
+#include <algorithm>
+#include <climits>
+
+#include "VehicleStore.h"
+#include "Vehicle.h"
+#include "EngineCore/ExceptionClass.h"
+using namespace std;
+
+const float VehicleStore::REGISTER_DST = 2.4;
+
+const float VehicleStore::COAST_MARGIN = 0.01;
+
+bool VehicleStore::Blinker::isLighting(const float time) const
+{
+    return fmod(time - startTime, 2 * duration) < duration;
+}
+
+VehicleStore::VehicleStore()
+{
+    liveCount = 0;
+    ticks = 0;
+    sleeping = true;
+    maxRate = MAX_RATE;
+    regions.resize(1);
+
+    kernelIsa = regions[0].following.getIsa();
+    kernelDeterministic = regions[0].following.isDeterministic();
+}
+
+int VehicleStore::allocate(const Kind vehicleKind)
+{
+    int slot;
+
+    if (freeSlots.size() > 0)
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = owner.size();
+
+        xPos.push_back(0);
+        nextXPos.push_back(0);
+        velocity.push_back(0);
+        dstToCross.push_back(0);
+
+        maxV.push_back(0);
+        minV.push_back(0);
+        cornerVelocity.push_back(0);
+        stopTime.push_back(1);
+        acceleration.push_back(0);
+        vehicleLength.push_back(0);
+        remainDst.push_back(0);
+        sleepGap.push_back(0);
+        dueTick.push_back(0);
+
+        lane.push_back(0);
+        state.push_back(DRIVING);
+        flags.push_back(0);
+        kind.push_back(CAR);
+
+        owner.push_back(nullptr);
+        generation.push_back(0);
+        color.push_back(Vec3());
+        position.push_back(Vec3());
+        rotation.push_back(Vec3());
+        busAngle.push_back(0);
+        blinker.push_back(Blinker());
+        waitLane.push_back(0);
+        waitSpace.push_back(0);
+        kindIndex.push_back(-1);
+    }
+
+    kind[slot] = vehicleKind;
+    kindIndex[slot] = kindSlots[vehicleKind].size();
+    kindSlots[vehicleKind].push_back(slot);
+
+    state[slot] = DRIVING;
+    flags[slot] = 0;
+    busAngle[slot] = 0;
+
+    liveCount++;
+
+    return slot;
+}
+
+void VehicleStore::release(const int slot)
+{
+    owner[slot] = nullptr;
+    generation[slot]++;
+
+    std::vector<int> &slots = kindSlots[kind[slot]];
+    const int moved = slots.back();
+    slots[kindIndex[slot]] = moved;
+    kindIndex[moved] = kindIndex[slot];
+    slots.pop_back();
+    kindIndex[slot] = -1;
+    state[slot] = DRIVING;
+    flags[slot] = 0;
+
+    freeSlots.push_back(slot);
+    liveCount--;
+}
+
+int VehicleStore::size() const
+{
+    return liveCount;
+}
+
+int VehicleStore::capacity() const
+{
+    return owner.size();
+}
+
+const std::vector<int>& VehicleStore::getKindSlots(const Kind vehicleKind) const
+{
+    return kindSlots[vehicleKind];
+}
+
+int VehicleStore::addRoad(const float length)
+{
+    //both lanes of a road share its length, new lanes belong to the first region
+    //until the network is partitioned
+    for (int l = 0; l < 2; l++)
+    {
+        const int laneIndex = lanes.size();
+
+        lanes.push_back(SlotRing());
+        laneLength.push_back(length);
+        laneTail.push_back(length);
+        laneCoastTick.push_back(0);
+        laneReserved.push_back(0);
+        laneRemote.push_back(false);
+        laneWatched.push_back(false);
+        laneHeading.push_back(0);
+
+        Region &region = regions[0];
+        laneRegion.push_back(0);
+        lanePosition.push_back(region.lanes.size());
+        region.lanes.push_back(laneIndex);
+        if (region.lanes.size() > region.activeLanes.size() * 64) region.activeLanes.push_back(0);
+    }
+
+    laneEntry.resize(lanes.size());
+    laneExit.resize(lanes.size());
+
+    return laneLength.size() / 2 - 1;
+}
+
+void VehicleStore::setLaneGeometry(const int laneIndex, const Vec3 entry, const Vec3 exit, const float heading)
+{
+    laneEntry.set(laneIndex, entry);
+    laneExit.set(laneIndex, exit);
+    laneHeading[laneIndex] = heading;
+}
+
+int VehicleStore::getLanesNumber() const
+{
+    return lanes.size();
+}
+
+float VehicleStore::getLaneLength(const int laneIndex) const
+{
+    return laneLength[laneIndex];
+}
+
+const SlotRing& VehicleStore::getLane(const int laneIndex) const
+{
+    return lanes[laneIndex];
+}
+
+void VehicleStore::activateLane(const int laneIndex)
+{
+    const int p = lanePosition[laneIndex];
+    regions[laneRegion[laneIndex]].activeLanes[p / 64] |= (uint64_t)1 << (p % 64);
+}
+
+void VehicleStore::enterLane(const int laneIndex, const int slot)
+{
+    lanes[laneIndex].push(slot);
+    laneTail[laneIndex] = xPos[slot];
+    laneCoastTick[laneIndex] = 0;
+
+    activateLane(laneIndex);
+
+    if (laneWatched[laneIndex]) enteredLanes.push_back(laneIndex);
+}
+
+void VehicleStore::watchLane(const int laneIndex, const bool watch)
+{
+    laneWatched[laneIndex] = watch;
+}
+
+std::vector<int>& VehicleStore::getEnteredLanes()
+{
+    return enteredLanes;
+}
+
+//The new first vehicle of the lane may have been asleep behind the one leaving
+void VehicleStore::leaveLane(const int laneIndex)
+{
+    lanes[laneIndex].pop();
+    laneCoastTick[laneIndex] = 0;
+
+    if (lanes[laneIndex].empty())
+        laneTail[laneIndex] = laneLength[laneIndex];
+    else
+        activateLane(laneIndex);
+}
+
+float VehicleStore::getFreeSpace(const int laneIndex) const
+{
+    return laneTail[laneIndex] - laneReserved[laneIndex];
+}
+
+void VehicleStore::reserveSpace(const int laneIndex, const float space)
+{
+    laneReserved[laneIndex] += space;
+}
+
+void VehicleStore::moveVehicle(const int fromLane, const int toLane, const int slot, const float space)
+{
+    Move move;
+    move.fromLane = fromLane;
+    move.toLane = toLane;
+    move.slot = slot;
+    move.space = space;
+
+    regions[laneRegion[fromLane]].moves.push_back(move);
+}
+
+void VehicleStore::setRegions(const std::vector<int> &newLaneRegion, const int regionsNumber)
+{
+    regions.assign(regionsNumber, Region());
+    laneRegion = newLaneRegion;
+
+    for (auto &region : regions)
+    {
+        region.following.setKernel(kernelIsa, kernelDeterministic);
+    }
+
+    for (unsigned int l = 0; l < lanes.size(); l++)
+    {
+        Region &region = regions[laneRegion[l]];
+
+        lanePosition[l] = region.lanes.size();
+        region.lanes.push_back(l);
+        if (region.lanes.size() > region.activeLanes.size() * 64) region.activeLanes.push_back(0);
+
+        if (!lanes[l].empty()) activateLane(l);
+    }
+}
+
+int VehicleStore::getRegionsNumber() const
+{
+    return regions.size();
+}
+
+//Car following on straight lanes in two phases. Reading phase computes the next
+//state of every vehicle from the state of the previous tick only - xPos of the
+//leader is read from the current buffer and the new position written to the next
+//one - so regions can be processed in any order and by many threads at once.
+//Then the buffers are swapped (swapPositions) and the transitions run on the new state.
+//
+//Every lane is visited from the first vehicle to the last; the leader of a vehicle
+//is the previous slot of the ring. The gap ahead of every driving vehicle and its
+//parameters are gathered into contiguous arrays, new velocities are computed for
+//all of them at once by the CarFollowing kernel and scattered back in the same
+//order; a vehicle that comes close to the end of its lane is flagged and listed
+//for the transition pass.
+//
+//A vehicle stopped by the kernel falls asleep. The velocity grows with the gap, so
+//while the gap ahead doesn't grow above the one it stopped at the kernel would
+//stop it again - it is skipped until its leader drives away or leaves the lane. A
+//lane whose vehicles have all slept through the tick and have no transitions to
+//do is no longer visited; it is brought back by a vehicle entering or leaving it
+//or by its intersection letting a vehicle in. Skipped vehicles end in the same
+//state as updated ones would, so the results don't depend on the sleeping.
+//
+//The car following runs at many rates at once (see chooseRate): a vehicle driving
+//at its maximal velocity far from its leader and from the end of its lane only
+//moves on at that velocity in every tick and computes the next one after 2^rate
+//ticks, vehicles close to others or to the intersection compute it in every tick.
+//Once all vehicles of a lane coast, until the first of them is due the lane only
+//moves them on, without gathering anything.
+
+void VehicleStore::updateDriving(const int r, const float delta)
+{
+    Region &region = regions[r];
+    CarFollowing::Batch &following = region.following;
+
+    for (int k = 0; k < KINDS; k++)
+    {
+        region.transitions[k].clear();
+    }
+
+    region.visited.clear();
+    region.tails.clear();
+
+    int count = 0;
+    int total = 0;
+    int asleep = 0;
+    int coasting = 0;
+
+    //rates chosen for a shorter step no longer hold
+    const bool coastingValid = delta <= region.coastDelta;
+    region.coastDelta = delta;
+
+    for (unsigned int w = 0; w < region.activeLanes.size(); w++)
+    {
+        uint64_t bits = region.activeLanes[w];
+
+        while (bits != 0)
+        {
+            const int b = __builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            const int l = region.lanes[w * 64 + b];
+            const SlotRing &ring = lanes[l];
+            const float length = laneLength[l];
+
+            //emptied lane is no longer visited
+            if (ring.empty())
+            {
+                region.activeLanes[w] &= ~((uint64_t)1 << b);
+                continue;
+            }
+
+            following.reserve(count + ring.size());
+
+            region.tails.push_back(ring.back());
+            total += ring.size();
+
+            if (coastingValid && ticks < laneCoastTick[l])
+            {
+                for (int k = 0; k < ring.size(); k++)
+                {
+                    const int i = ring[k];
+                    const float x = xPos[i] + velocity[i] * delta;
+
+                    nextXPos[i] = x;
+                    dstToCross[i] = length - x;
+                }
+
+                coasting += ring.size();
+                continue;
+            }
+
+            bool dormant = true;
+            bool allCoasting = true;
+            int coastTick = INT_MAX;
+
+            for (int k = 0; k < ring.size(); k++)
+            {
+                const int i = ring[k];
+
+                if (state[i] != DRIVING)
+                {
+                    nextXPos[i] = xPos[i];
+                    region.visited.push_back(i);
+                    dormant = false;
+                    allCoasting = false;
+                    continue;
+                }
+
+                const float x = xPos[i] + velocity[i] * delta;
+
+                if (flags[i] & COASTING)
+                {
+                    if (coastingValid && ticks < dueTick[i])
+                    {
+                        nextXPos[i] = x;
+                        dstToCross[i] = length - x;
+                        dormant = false;
+                        coastTick = min(coastTick, dueTick[i]);
+                        coasting++;
+                        continue;
+                    }
+
+                    flags[i] &= ~COASTING;
+                }
+
+                allCoasting = false;
+
+                //a leader that has left the lane for the intersection no longer counts
+                const int front = k > 0 ? ring[k - 1] : -1;
+
+                float gap;
+
+                if (front >= 0 && state[front] != CORNERING)
+                    gap = xPos[front] - x - vehicleLength[front] * 0.5f;
+                else
+                    gap = length - x;
+
+                nextXPos[i] = x;
+
+                if (flags[i] & ASLEEP)
+                {
+                    if (gap <= sleepGap[i])
+                    {
+                        if ((flags[i] & (TRANSITION | WAITING)) == TRANSITION)
+                        {
+                            region.visited.push_back(i);
+                            dormant = false;
+                        }
+
+                        asleep++;
+                        continue;
+                    }
+
+                    flags[i] &= ~ASLEEP;
+                }
+
+                region.visited.push_back(i);
+                dormant = false;
+
+                following.gap[count] = gap;
+                following.prevVelocity[count] = velocity[i];
+                following.vehicleLength[count] = vehicleLength[i];
+                following.remainDst[count] = remainDst[i];
+                following.acceleration[count] = acceleration[i];
+                following.stopTime[count] = stopTime[i];
+                following.minV[count] = minV[i];
+                following.maxV[count] = maxV[i];
+                count++;
+            }
+
+            laneCoastTick[l] = allCoasting ? coastTick : 0;
+
+            //both position buffers of its vehicles are equal now, so it may be skipped
+            if (dormant) region.activeLanes[w] &= ~((uint64_t)1 << b);
+        }
+    }
+
+    CarFollowing::compute(following, count, delta);
+
+    region.awake = total - asleep;
+    region.coasting = coasting;
+    count = 0;
+
+    //only the vehicles computed by the kernel or having a transition to do
+    for (const auto i : region.visited)
+    {
+        if (state[i] == DRIVING && !(flags[i] & ASLEEP))
+        {
+            const float length = laneLength[lane[i]];
+            float x = nextXPos[i];
+
+            unsigned char f = flags[i] & ~BRAKING;
+            if (following.braking[count]) f |= BRAKING;
+
+            if (x > length) x = length;
+
+            if (length - x < REGISTER_DST) f |= TRANSITION;
+
+            //stopped vehicle sleeps from the next tick
+            if (sleeping && following.velocity[count] == 0)
+            {
+                f |= ASLEEP;
+                sleepGap[i] = following.gap[count];
+            }
+
+            if (maxRate > 0 && following.velocity[count] == maxV[i] && !following.braking[count])
+            {
+                const int rate = chooseRate(i, following.gap[count], x, delta);
+
+                //due at a multiple of 2^rate, so vehicles of one lane fall due together
+                if (rate > 0)
+                {
+                    f |= COASTING;
+                    dueTick[i] = (ticks + (1 << rate)) & ~((1 << rate) - 1);
+                }
+            }
+
+            nextXPos[i] = x;
+            velocity[i] = following.velocity[count];
+            dstToCross[i] = length - x;
+            flags[i] = f;
+
+            count++;
+        }
+
+        if ((flags[i] & (TRANSITION | WAITING)) == TRANSITION) region.transitions[kind[i]].push_back(i);
+    }
+
+    for (const auto i : region.tails)
+    {
+        laneTail[lane[i]] = nextXPos[i];
+    }
+}
+
+//The highest rate whose ticks the vehicle surely drives through at its maximal
+//velocity. Until then the vehicle gets closer to its leader by at most maxV * time,
+//even if the leader stopped dead, and its velocity grows with the gap - so if the
+//car following still gives at least maxV for the gap shrunk by that much (and a
+//margin), it gives maxV in every tick until then, and the vehicle doesn't come to
+//REGISTER_DST from the end of its lane either. Its fine-step trajectory is then
+//x += maxV * delta in every tick, exactly what coasting does, so the results equal
+//the ones of computing every vehicle in every tick bit for bit. A longer step
+//than the one the rate was chosen for makes every vehicle compute its velocity.
+
+int VehicleStore::chooseRate(const int i, const float gap, const float x, const float delta) const
+{
+    const float st = stopTime[i];
+    const float step = maxV[i] * delta;
+
+    //gap for which the car following gives exactly maxV
+    const float freeGap = maxV[i] * st + vehicleLength[i] * 0.5f + remainDst[i] + acceleration[i] * st * st * 0.5f;
+    const float room = min(gap - freeGap, laneLength[lane[i]] - x - REGISTER_DST) - COAST_MARGIN;
+
+    int rate = 0;
+    while (rate < maxRate && step * (2 << rate) <= room) rate++;
+
+    //the same check as computed by CarFollowing, so rounding can't make it wrong
+    while (rate > 0)
+    {
+        const float posDiff = gap - step * (1 << rate) - COAST_MARGIN - vehicleLength[i] * 0.5f - remainDst[i];
+        if ((posDiff - acceleration[i] * st * st * 0.5f) / st >= maxV[i]) break;
+
+        rate--;
+    }
+
+    return rate;
+}
+
+void VehicleStore::swapPositions()
+{
+    xPos.swap(nextXPos);
+    ticks++;
+}
+
+bool VehicleStore::setKernel(const CarFollowing::Isa isa, const bool deterministic)
+{
+    if (!CarFollowing::isSupported(isa)) return false;
+
+    kernelIsa = isa;
+    kernelDeterministic = deterministic;
+
+    for (auto &region : regions)
+    {
+        region.following.setKernel(isa, deterministic);
+    }
+
+    return true;
+}
+
+CarFollowing::Isa VehicleStore::getKernelIsa() const
+{
+    return kernelIsa;
+}
+
+bool VehicleStore::isKernelDeterministic() const
+{
+    return kernelDeterministic;
+}
+
+void VehicleStore::setWaiting(const int slot)
+{
+    if (sleeping) flags[slot] |= WAITING;
+}
+
+void VehicleStore::waitForSpace(const int slot, const int toLane)
+{
+    if (!sleeping) return;
+
+    flags[slot] |= BLOCKED;
+    waitLane[slot] = toLane;
+    waitSpace[slot] = getFreeSpace(toLane);
+}
+
+void VehicleStore::wake(const int slot)
+{
+    flags[slot] &= ~(WAITING | BLOCKED);
+    activateLane(lane[slot]);
+}
+
+int VehicleStore::getAwakeCount() const
+{
+    int awake = 0;
+
+    for (const auto &region : regions)
+    {
+        awake += region.awake;
+    }
+
+    return awake;
+}
+
+int VehicleStore::getCoastingCount() const
+{
+    int coasting = 0;
+
+    for (const auto &region : regions)
+    {
+        coasting += region.coasting;
+    }
+
+    return coasting;
+}
+
+void VehicleStore::setMaxRate(const int rate)
+{
+    if (rate < 0 || rate > MAX_RATE) throw ExceptionClass("max rate must be from 0 to " + to_string(MAX_RATE));
+
+    maxRate = rate;
+}
+
+int VehicleStore::getMaxRate() const
+{
+    return maxRate;
+}
+
+void VehicleStore::setSleeping(const bool isSleeping)
+{
+    sleeping = isSleeping;
+}
+
+bool VehicleStore::isSleeping() const
+{
+    return sleeping;
+}
+
+//Registering at intersections, changing lanes and cornering - handled by the owning
+//objects, only for the few vehicles flagged as being in a transition, in one batch
+//per kind of vehicles (see VehicleKind). A vehicle only changes the state of its
+//region, moving to the next lane is queued for commitMoves.
+
+void VehicleStore::updateTransitions(const int r, const float delta)
+{
+    Region &region = regions[r];
+
+    Car::updateBatch(*this, region.transitions[CAR], delta);
+    Bus::updateBatch(*this, region.transitions[BUS], delta);
+}
+
+//Barrier at the end of the tick - vehicles are handed over to their new lanes
+//region by region, each region in the order of its moves
+void VehicleStore::commitMoves()
+{
+    for (auto &region : regions)
+    {
+        for (const auto &move : region.moves)
+        {
+            leaveLane(move.fromLane);
+            laneReserved[move.toLane] -= move.space;
+
+            if (laneRemote[move.toLane])
+            {
+                Departure departure;
+                departure.slot = move.slot;
+                departure.toLane = move.toLane;
+                departures.push_back(departure);
+
+                laneTail[move.toLane] = xPos[move.slot];
+            }
+            else
+            {
+                enterLane(move.toLane, move.slot);
+            }
+        }
+
+        region.moves.clear();
+    }
+}
+
+void VehicleStore::setRemoteLanes(const std::vector<bool> &remote)
+{
+    laneRemote = remote;
+}
+
+std::vector<VehicleStore::Departure>& VehicleStore::getDepartures()
+{
+    return departures;
+}
+
+float VehicleStore::getLaneTail(const int laneIndex) const
+{
+    return laneTail[laneIndex];
+}
+
+void VehicleStore::setLaneTail(const int laneIndex, const float tail)
+{
+    laneTail[laneIndex] = tail;
+}
+
+void VehicleStore::updateLanePositions()
+{
+    if (renderFrom.size() < capacity())
+    {
+        renderFrom.resize(capacity());
+        renderTo.resize(capacity());
+        renderProgress.resize(capacity());
+        renderSlots.resize(capacity());
+    }
+
+    int n = 0;
+
+    for (int i = 0; i < capacity(); i++)
+    {
+        if (owner[i] == nullptr || state[i] == CORNERING) continue;
+
+        const int l = lane[i];
+
+        float s = xPos[i] / laneLength[l];
+        if (state[i] == DRIVING && s > 1) s = 1;
+
+        renderSlots[n] = i;
+        renderProgress[n] = s;
+        renderFrom.set(n, laneEntry.get(l));
+        renderTo.set(n, laneExit.get(l));
+        n++;
+    }
+
+    if (n == 0) return;
+
+    Vec3Array::lerp(renderFrom, renderTo, &renderProgress[0], renderFrom, n);
+
+    for (int k = 0; k < n; k++)
+    {
+        const int i = renderSlots[k];
+
+        position[i] = renderFrom.get(k);
+        rotation[i] = Vec3(0, laneHeading[lane[i]], 0);
+    }
+}
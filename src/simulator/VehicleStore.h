@@ -0,0 +1,301 @@
+///   EN: Project for OOP subject at Warsaw University of Technology
+///       City traffic simulation
+///
+///   PL: Projekt PROI (Programowanie obiektowe) PW WEiTI 18L
+///       Symulacja ruchu miejskiego
+///
+///   Copyright (C) Robert Dudzinski 2018
+///
+///   File: VehicleStore.h
+
+
+#ifndef VEHICLESTORE_H
+#define VEHICLESTORE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "EngineCore/Vec3.h"
+#include "SlotRing.h"
+#include "CarFollowing.h"
+
+class Vehicle;
+
+//Structure of arrays with the state of all vehicles of a simulation. Every vehicle
+//owns one slot, every directional lane keeps the ordered slots of its vehicles.
+//Hot arrays are read and written by the per-tick kinematics, cold arrays are used
+//only for drawing and for rare transitions at intersections.
+//Lanes are grouped into regions of the road network (see Simulation::partition).
+
+class VehicleStore
+{
+public:
+    enum State
+    {
+        DRIVING,
+        CHANGING,
+        CORNERING
+    };
+
+    enum Kind
+    {
+        CAR,
+        BUS,
+        KINDS
+    };
+
+    enum Flags
+    {
+        BRAKING     = 1,
+        TRANSITION  = 2,
+
+        //stopped, skipped by the car following while the gap ahead doesn't grow
+        ASLEEP      = 4,
+
+        //registered at the intersection, skipped by the transitions until let in
+        WAITING     = 8,
+
+        //let in, skipped by the transitions until the free space of its next lane changes
+        BLOCKED     = 16,
+
+        //driving freely, its velocity is not computed until dueTick
+        COASTING    = 32
+    };
+
+    struct Blinker
+    {
+        int which;
+        float startTime;
+        float duration;
+
+        bool isLighting(const float time) const;
+    };
+
+    //hot; xPos is the only state a vehicle reads from another one, it is double
+    //buffered so the car following of a tick sees positions of the previous tick
+    std::vector<float> xPos;
+    std::vector<float> nextXPos;
+    std::vector<float> velocity;
+    std::vector<float> dstToCross;
+
+    std::vector<float> maxV;
+    std::vector<float> minV;
+    std::vector<float> cornerVelocity;
+    std::vector<float> stopTime;
+    std::vector<float> acceleration;
+    std::vector<float> vehicleLength;
+    std::vector<float> remainDst;
+    std::vector<float> sleepGap;
+    std::vector<int> dueTick;
+
+    std::vector<int> lane;
+    std::vector<unsigned char> state;
+    std::vector<unsigned char> flags;
+    std::vector<unsigned char> kind;
+
+    //cold
+    std::vector<Vehicle*> owner;
+    std::vector<uint32_t> generation;
+    std::vector<Vec3> color;
+    std::vector<Vec3> position;
+    std::vector<Vec3> rotation;
+    std::vector<float> busAngle;
+    std::vector<Blinker> blinker;
+
+    //next lane of a blocked vehicle and its free space at the last try
+    std::vector<int> waitLane;
+    std::vector<float> waitSpace;
+
+    VehicleStore();
+
+    int allocate(const Kind vehicleKind);
+    void release(const int slot);
+
+    int size() const;
+    int capacity() const;
+
+    const std::vector<int>& getKindSlots(const Kind vehicleKind) const;
+
+    int addRoad(const float length);
+    void setLaneGeometry(const int laneIndex, const Vec3 entry, const Vec3 exit, const float heading);
+    int getLanesNumber() const;
+    float getLaneLength(const int laneIndex) const;
+    const SlotRing& getLane(const int laneIndex) const;
+
+    void enterLane(const int laneIndex, const int slot);
+    void leaveLane(const int laneIndex);
+
+    //watched lanes entered since the list was last cleared, so their owners don't
+    //have to look at them every tick
+    void watchLane(const int laneIndex, const bool watch);
+    std::vector<int>& getEnteredLanes();
+
+    //free space at the beginning of a lane as seen by the transitions of a tick -
+    //position of its last vehicle at the end of the car following, less the space
+    //reserved by vehicles already let into the intersection towards the lane
+    float getFreeSpace(const int laneIndex) const;
+    void reserveSpace(const int laneIndex, const float space);
+
+    //vehicle leaving the front of one lane for the end of another; done by
+    //commitMoves at the end of the tick, when the reserved space is also returned
+    void moveVehicle(const int fromLane, const int toLane, const int slot, const float space);
+
+    //regions are updated independently of each other, in any order or in parallel;
+    //laneRegion gives the region of every lane
+    void setRegions(const std::vector<int> &laneRegion, const int regionsNumber);
+    int getRegionsNumber() const;
+
+    void updateDriving(const int region, const float delta);
+    void swapPositions();
+
+    //car following kernel of every region, the best one of this CPU by default;
+    //false if the CPU doesn't support the instruction set
+    bool setKernel(const CarFollowing::Isa isa, const bool deterministic);
+    CarFollowing::Isa getKernelIsa() const;
+    bool isKernelDeterministic() const;
+
+    //vehicles with nothing to do are put to sleep (see updateDriving); waking
+    //one also brings back its lane if it was no longer visited
+    void setWaiting(const int slot);
+    void waitForSpace(const int slot, const int toLane);
+    void wake(const int slot);
+
+    bool isBlocked(const int slot) const
+    {
+        return (flags[slot] & BLOCKED) && getFreeSpace(waitLane[slot]) == waitSpace[slot];
+    }
+
+    //vehicles not asleep in the last tick, counted by the car following, and the
+    //ones of them coasting
+    int getAwakeCount() const;
+    int getCoastingCount() const;
+
+    //on by default; off, every vehicle is updated in every tick. Set before the
+    //first tick
+    void setSleeping(const bool isSleeping);
+    bool isSleeping() const;
+
+    //velocity of a freely driving vehicle is computed every 2^rate ticks at most,
+    //0 to MAX_RATE (default); 0 computes it in every tick
+    void setMaxRate(const int rate);
+    int getMaxRate() const;
+
+    static const int MAX_RATE = 6;
+
+    void updateTransitions(const int region, const float delta);
+    void commitMoves();
+
+    //lanes updated by another process of a distributed simulation; a vehicle moving
+    //to such a lane is not entered there but listed as a departure and the lane's
+    //tail is only known from the messages of its owner
+    void setRemoteLanes(const std::vector<bool> &remote);
+
+    struct Departure
+    {
+        int slot;
+        int toLane;
+    };
+
+    std::vector<Departure>& getDepartures();
+
+    float getLaneTail(const int laneIndex) const;
+    void setLaneTail(const int laneIndex, const float tail);
+
+    //drawing position and heading of every vehicle along a lane, interpolated
+    //between the ends of their lanes in one batch; vehicles in intersections are
+    //placed by their owners
+    void updateLanePositions();
+
+    static const float REGISTER_DST;
+
+    //distance kept on top of the worst case when choosing the rate, far more than
+    //the rounding errors of the positions
+    static const float COAST_MARGIN;
+
+private:
+    VehicleStore(const VehicleStore&);
+    VehicleStore& operator = (const VehicleStore&);
+
+    struct Move
+    {
+        int fromLane;
+        int toLane;
+        int slot;
+        float space;
+    };
+
+    struct Region
+    {
+        //lanes of the region in the order of their indexes, a bit for every one
+        //of them with vehicles - the only ones visited by the car following
+        std::vector<int> lanes;
+        std::vector<uint64_t> activeLanes;
+
+        //vehicles flagged for the transition pass in this tick, by kind
+        std::vector<int> transitions[KINDS];
+
+        //vehicles of the visited lanes in the order of the car following which
+        //are computed by the kernel or may have a transition to do, the inputs of
+        //the driving ones gathered for the kernel, and the last vehicle of every lane
+        std::vector<int> visited;
+        CarFollowing::Batch following;
+        std::vector<int> tails;
+        int awake;
+        int coasting;
+
+        //step of the last tick, the coasting rates were chosen for it
+        float coastDelta;
+
+        //written only by the thread updating the region, emptied at the barrier
+        std::vector<Move> moves;
+    };
+
+    //vehicles of every directional lane, from the first one to the last
+    std::vector<SlotRing> lanes;
+    std::vector<float> laneLength;
+    std::vector<float> laneTail;
+    std::vector<float> laneReserved;
+
+    //tick until which every vehicle of the lane coasts, reset when one enters or leaves
+    std::vector<int> laneCoastTick;
+
+    std::vector<Region> regions;
+    std::vector<int> laneRegion;
+    std::vector<int> lanePosition;
+
+    Vec3Array laneEntry;
+    Vec3Array laneExit;
+    std::vector<float> laneHeading;
+
+    //gathered ends of the lanes and progress along them, for updateLanePositions
+    Vec3Array renderFrom;
+    Vec3Array renderTo;
+    std::vector<float> renderProgress;
+    std::vector<int> renderSlots;
+
+    std::vector<bool> laneWatched;
+    std::vector<int> enteredLanes;
+
+    std::vector<bool> laneRemote;
+    std::vector<Departure> departures;
+
+    void activateLane(const int laneIndex);
+
+    std::vector<int> freeSlots;
+
+    //slots of the vehicles of every kind, each vehicle knows its index there
+    std::vector<int> kindSlots[KINDS];
+    std::vector<int> kindIndex;
+
+    int liveCount;
+    int ticks;
+
+    CarFollowing::Isa kernelIsa;
+    bool kernelDeterministic;
+    bool sleeping;
+    int maxRate;
+
+    int chooseRate(const int slot, const float gap, const float x, const float delta) const;
+};
+
+#endif // VEHICLESTORE_H